@@ -0,0 +1,742 @@
+#include "bench.h"
+#include "cpu.h"
+#include "io.h"
+#include "ipc.h"
+#include "process.h"
+#include "scheduler.h"
+#include "console.h"
+#include "serial.h"
+#include "vga.h"
+#include "vfs.h"
+#include "elf.h"
+#include "memory.h"
+#include "shm.h"
+#include "sync.h"
+#include "task.h"
+#include "string.h"
+
+#define BENCH_ROUNDS 1000
+
+static int bench_server_pid;
+static int bench_client_pid;
+static int bench_failed;
+static uint32_t bench_cycles;
+
+/* TSC frequency, measured against a 10 ms one-shot on PIT channel 2 */
+static uint32_t tsc_khz(void) {
+    uint16_t latch = 11932;     /* 1193182 Hz / 100 */
+
+    outb(0x61, (inb(0x61) & ~0x02) | 0x01);    /* gate on, speaker off */
+    outb(0x43, 0xB0);                           /* ch2, lo/hi, mode 0 */
+    outb(0x42, latch & 0xFF);
+    outb(0x42, latch >> 8);
+
+    uint64_t t0 = rdtsc();
+    while (!(inb(0x61) & 0x20));                /* wait for OUT2 */
+    return (uint32_t)(rdtsc() - t0) / 10;
+}
+
+static void bench_report(const char* name, uint32_t cycles, int rounds) {
+    console_puts(name);
+    if (bench_failed) {
+        console_puts("FAILED\n");
+        return;
+    }
+    console_putint(cycles / rounds);
+    console_puts(" cycles/round-trip\n");
+}
+
+/* =========================
+   Call/reply fast path
+   ========================= */
+static void pingpong_server(void) {
+    int msg;
+    int reply = 0;
+
+    /* Echo msg+1 until terminated while parked */
+    while (ipc_reply_wait(reply, &msg) >= 0) {
+        reply = msg + 1;
+    }
+}
+
+static void pingpong_client(void) {
+    int reply = 0;
+    uint64_t t0 = rdtsc();
+
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        if (ipc_call(bench_server_pid, i, &reply) < 0 || reply != i + 1) {
+            bench_failed = 1;
+            break;
+        }
+    }
+    bench_cycles = (uint32_t)(rdtsc() - t0);
+}
+
+/* =========================
+   Queued path
+   Both sides poll their mailbox and yield, so every
+   message costs a full scheduler pass
+   ========================= */
+static void queued_server(void) {
+    int self = get_current_process()->pid;
+    int msg;
+
+    for (;;) {
+        while (ipc_recv(self, &msg) < 0)
+            scheduler_yield();
+        if (msg < 0)
+            return;
+        ipc_send(bench_client_pid, msg + 1);
+    }
+}
+
+static void queued_client(void) {
+    int self = get_current_process()->pid;
+    int reply;
+    uint64_t t0 = rdtsc();
+
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        if (ipc_send(bench_server_pid, i) < 0) {
+            bench_failed = 1;
+            break;
+        }
+        while (ipc_recv(self, &reply) < 0)
+            scheduler_yield();
+        if (reply != i + 1) {
+            bench_failed = 1;
+            break;
+        }
+    }
+    bench_cycles = (uint32_t)(rdtsc() - t0);
+    ipc_send(bench_server_pid, -1);
+}
+
+void bench_ipc(void) {
+    scheduler_init(1);
+    scheduler_set_verbose(0);
+
+    /* Fast path: park the server, then run the client against it */
+    bench_failed = 0;
+    bench_server_pid = process_create(pingpong_server);
+    schedule();
+    if (process_create(pingpong_client) >= 0)
+        schedule();
+    else
+        bench_failed = 1;
+    process_terminate(bench_server_pid);
+    bench_report("ipc_call/ipc_reply_wait:      ", bench_cycles, BENCH_ROUNDS);
+
+    /* Queued path: mailbox + scheduler pass on each hop */
+    bench_failed = 0;
+    bench_server_pid = process_create(queued_server);
+    bench_client_pid = process_create(queued_client);
+    if (bench_server_pid < 0 || bench_client_pid < 0)
+        bench_failed = 1;
+    while (get_ready_process() != 0)
+        schedule();
+    bench_report("ipc_send/schedule/ipc_recv:   ", bench_cycles, BENCH_ROUNDS);
+
+    scheduler_set_verbose(1);
+}
+
+/* =========================
+   Console backends
+   ========================= */
+#define CONSOLE_LINES 25
+
+static void console_report(const char* name, uint32_t cycles, uint32_t chars,
+                           uint32_t khz) {
+    uint32_t per_char = cycles / chars;
+    if (per_char == 0) per_char = 1;
+
+    console_puts(name);
+    console_putint(per_char);
+    console_puts(" cycles/char, ");
+    console_putint((khz / per_char) * 1000);
+    console_puts(" chars/s\n");
+}
+
+void bench_console(void) {
+    static const char line[] =
+        "The quick brown fox jumps over the lazy dog. 0123456789 "
+        "ABCDEFGHIJKLMNOPQRSTU\n";
+    uint32_t len = sizeof(line) - 1;
+    uint32_t chars = len * CONSOLE_LINES;
+    uint32_t khz = tsc_khz();
+
+    /* Full screen of text through the framebuffer (scrolls every line) */
+    uint64_t t0 = rdtsc();
+    for (int i = 0; i < CONSOLE_LINES; i++)
+        vga_write(line, len);
+    uint32_t vga_cycles = (uint32_t)(rdtsc() - t0);
+
+    /* Same text through the UART, one busy-wait per byte */
+    t0 = rdtsc();
+    for (int i = 0; i < CONSOLE_LINES; i++) {
+        for (uint32_t j = 0; j < len; j++)
+            serial_putc(line[j]);
+    }
+    uint32_t uart_cycles = (uint32_t)(rdtsc() - t0);
+
+    console_puts("TSC: ");
+    console_putint(khz);
+    console_puts(" kHz\n");
+    console_report("vga_write:   ", vga_cycles, chars, khz);
+    console_report("serial_putc: ", uart_cycles, chars, khz);
+}
+
+/* =========================
+   VFS reads
+   ========================= */
+#define VFS_CHUNK   4096
+#define VFS_PASSES  8
+
+static uint8_t vfs_copy_buf[VFS_CHUNK];
+
+/* Read every file once; returns bytes read, checksum in *sum */
+static uint32_t vfs_read_all(int copy, uint32_t* sum) {
+    vfs_stat_t st;
+    uint32_t total = 0;
+
+    for (int i = 0; vfs_readdir(i, &st) == 0; i++) {
+        const void* data;
+        int n;
+        int fd = vfs_open(st.name);
+        if (fd < 0) continue;
+
+        while ((n = vfs_read(fd, &data, VFS_CHUNK)) > 0) {
+            const uint32_t* words = (const uint32_t*)data;
+            if (copy) {
+                memcpy(vfs_copy_buf, data, n);
+                words = (const uint32_t*)vfs_copy_buf;
+            }
+            /* Touch the data so both paths pay for reading it */
+            for (int w = 0; w < n / 4; w++)
+                *sum += words[w];
+            total += n;
+        }
+        vfs_close(fd);
+    }
+    return total;
+}
+
+static void vfs_report(const char* name, uint32_t cycles, uint32_t bytes,
+                       uint32_t khz) {
+    uint32_t per_kb = cycles / (bytes / 1024);
+    if (per_kb == 0) per_kb = 1;
+
+    console_puts(name);
+    console_putint(per_kb);
+    console_puts(" cycles/KB, ");
+    console_putint((khz / per_kb) * 1000 / 1024);
+    console_puts(" MB/s\n");
+}
+
+void bench_vfs(void) {
+    uint32_t sum = 0;
+    uint32_t bytes = vfs_read_all(0, &sum);
+    if (bytes < 1024) {
+        console_puts("bench vfs: need at least 1 KB in the initrd\n");
+        return;
+    }
+    uint32_t khz = tsc_khz();
+
+    uint64_t t0 = rdtsc();
+    for (int p = 0; p < VFS_PASSES; p++)
+        vfs_read_all(0, &sum);
+    uint32_t zc_cycles = (uint32_t)(rdtsc() - t0);
+
+    t0 = rdtsc();
+    for (int p = 0; p < VFS_PASSES; p++)
+        vfs_read_all(1, &sum);
+    uint32_t copy_cycles = (uint32_t)(rdtsc() - t0);
+
+    console_puts("initrd bytes: "); console_putint(bytes);
+    console_puts(" (checksum "); console_putint(sum & 0x7FFFFFFF); console_puts(")\n");
+    vfs_report("vfs_read (zero-copy): ", zc_cycles, bytes * VFS_PASSES, khz);
+    vfs_report("vfs_read + memcpy:    ", copy_cycles, bytes * VFS_PASSES, khz);
+}
+
+/* =========================
+   Heap: kmalloc + kfree pairs
+   ========================= */
+#define HEAP_BATCH 8
+
+void bench_heap(void) {
+    void* ptrs[HEAP_BATCH];
+    heap_stats_t st;
+    int failed = 0;
+
+    uint64_t t0 = rdtsc();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < HEAP_BATCH; i++) {
+            ptrs[i] = kmalloc(16 << (i & 3));   /* 16..128 bytes */
+            if (!ptrs[i]) failed = 1;
+        }
+        for (int i = 0; i < HEAP_BATCH; i++)
+            kfree(ptrs[i]);
+    }
+    uint32_t cycles = (uint32_t)(rdtsc() - t0);
+
+    heap_get_stats(&st);
+    console_puts(st.instrumented ? "kmalloc+kfree (HEAP_DEBUG): " : "kmalloc+kfree: ");
+    if (failed) {
+        console_puts("FAILED\n");
+        return;
+    }
+    console_putint(cycles / (BENCH_ROUNDS * HEAP_BATCH));
+    console_puts(" cycles/pair\n");
+}
+
+/* =========================
+   Futex sync vs IPC
+   ========================= */
+#define SYNC_RING   16
+#define SYNC_ITEMS  (BENCH_ROUNDS * 4)
+
+typedef struct {
+    mutex_t lock;
+    cond_t not_empty;
+    cond_t not_full;
+    int head;
+    int count;
+    int buf[SYNC_RING];
+} sync_ring_t;
+
+static int sync_ring_id;
+static int sync_port;
+static uint64_t sync_t0;
+
+static void ring_producer(void) {
+    sync_ring_t* r = (sync_ring_t*)shm_attach(sync_ring_id);
+    if (!r) {
+        bench_failed = 1;
+        return;
+    }
+
+    sync_t0 = rdtsc();
+    for (int i = 0; i < SYNC_ITEMS; i++) {
+        mutex_lock(&r->lock);
+        while (r->count == SYNC_RING)
+            cond_wait(&r->not_full, &r->lock);
+        r->buf[(r->head + r->count) % SYNC_RING] = i;
+        r->count++;
+        cond_signal(&r->not_empty);
+        mutex_unlock(&r->lock);
+    }
+}
+
+static void ring_consumer(void) {
+    sync_ring_t* r = (sync_ring_t*)shm_attach(sync_ring_id);
+    if (!r) {
+        bench_failed = 1;
+        return;
+    }
+
+    for (int i = 0; i < SYNC_ITEMS; i++) {
+        mutex_lock(&r->lock);
+        while (r->count == 0)
+            cond_wait(&r->not_empty, &r->lock);
+        int v = r->buf[r->head];
+        r->head = (r->head + 1) % SYNC_RING;
+        r->count--;
+        cond_signal(&r->not_full);
+        mutex_unlock(&r->lock);
+
+        if (v != i) bench_failed = 1;
+    }
+    bench_cycles = (uint32_t)(rdtsc() - sync_t0);
+}
+
+static void port_producer(void) {
+    sync_t0 = rdtsc();
+    for (int i = 0; i < SYNC_ITEMS; i++) {
+        while (ipc_port_send(sync_port, i) < 0)
+            scheduler_yield();     /* port full */
+    }
+}
+
+static void port_consumer(void) {
+    int v;
+    for (int i = 0; i < SYNC_ITEMS; i++) {
+        if (ipc_port_recv(sync_port, &v) < 0 || v != i)
+            bench_failed = 1;
+    }
+    bench_cycles = (uint32_t)(rdtsc() - sync_t0);
+}
+
+/* Lock/unlock through a server: one ipc_call each */
+static void ipc_lock_client(void) {
+    int reply;
+    uint64_t t0 = rdtsc();
+
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        if (ipc_call(bench_server_pid, 1, &reply) < 0 ||
+            ipc_call(bench_server_pid, 0, &reply) < 0) {
+            bench_failed = 1;
+            break;
+        }
+    }
+    bench_cycles = (uint32_t)(rdtsc() - t0);
+}
+
+static void sync_report(const char* name, uint32_t cycles, int n, const char* unit) {
+    console_puts(name);
+    if (bench_failed) {
+        console_puts("FAILED\n");
+        return;
+    }
+    console_putint(cycles / n);
+    console_puts(unit);
+}
+
+static void sync_run_pair(void (*first)(void), void (*second)(void)) {
+    bench_failed = 0;
+    if (process_create(first) < 0 || process_create(second) < 0)
+        bench_failed = 1;
+    while (get_ready_process() != 0)
+        schedule();
+}
+
+void bench_sync(void) {
+    mutex_t m = MUTEX_INIT;
+
+    scheduler_init(1);
+    scheduler_set_verbose(0);
+
+    /* Uncontended: the lock word never leaves the atomic fast path */
+    bench_failed = 0;
+    uint64_t t0 = rdtsc();
+    for (int i = 0; i < BENCH_ROUNDS; i++) {
+        mutex_lock(&m);
+        mutex_unlock(&m);
+    }
+    bench_cycles = (uint32_t)(rdtsc() - t0);
+    sync_report("mutex lock/unlock (uncontended): ", bench_cycles, BENCH_ROUNDS,
+                " cycles/pair\n");
+
+    bench_failed = 0;
+    bench_server_pid = process_create(pingpong_server);
+    schedule();
+    if (process_create(ipc_lock_client) >= 0)
+        schedule();
+    else
+        bench_failed = 1;
+    process_terminate(bench_server_pid);
+    sync_report("lock server via ipc_call:        ", bench_cycles, BENCH_ROUNDS,
+                " cycles/pair\n");
+
+    /* Producer/consumer through a 16-slot ring */
+    sync_ring_id = shm_create("bench.ring", sizeof(sync_ring_t));
+    if (sync_ring_id >= 0) {
+        sync_run_pair(ring_producer, ring_consumer);
+        shm_destroy(sync_ring_id);
+    } else {
+        bench_failed = 1;
+    }
+    sync_report("shm ring + mutex/condvar:        ", bench_cycles, SYNC_ITEMS,
+                " cycles/item\n");
+
+    sync_port = ipc_port_create("bench.sync", SYNC_RING);
+    if (sync_port >= 0) {
+        sync_run_pair(port_producer, port_consumer);
+        ipc_port_destroy(sync_port);
+    } else {
+        bench_failed = 1;
+    }
+    sync_report("ipc_port_send/ipc_port_recv:     ", bench_cycles, SYNC_ITEMS,
+                " cycles/item\n");
+
+    scheduler_set_verbose(1);
+}
+
+/* =========================
+   Tasks: process per task vs task runtime
+   ========================= */
+#define FIB_N       22
+#define FIB_CUTOFF  10      /* below this, plain recursion */
+#define QS_N        4096
+#define QS_GRAIN    128
+
+/* Process per task: a child process reads fn/arg from its slot */
+typedef struct {
+    task_fn_t fn;
+    void* arg;
+} ppt_job_t;
+
+static ppt_job_t ppt_jobs[MAX_PROCESSES];
+static uint32_t ppt_created;
+static uint32_t ppt_inlined;
+static int bench_use_tasks;
+
+static void ppt_entry(void) {
+    ppt_job_t* job = &ppt_jobs[get_process_index(get_current_process()->pid)];
+    job->fn(job->arg);
+}
+
+static int ppt_spawn(task_fn_t fn, void* arg) {
+    int pid = process_create(ppt_entry);
+    if (pid < 0) {
+        ppt_inlined++;      /* table full */
+        fn(arg);
+        return -1;
+    }
+    ppt_jobs[get_process_index(pid)].fn = fn;
+    ppt_jobs[get_process_index(pid)].arg = arg;
+    ppt_created++;
+    return pid;
+}
+
+static void ppt_join(int pid) {
+    while (pid >= 0 && get_process_by_pid(pid) != 0)
+        scheduler_yield();
+}
+
+/* spawn/join through whichever backend is being measured */
+typedef struct {
+    task_t* task;
+    int pid;
+} bench_handle_t;
+
+static bench_handle_t bench_spawn_job(task_fn_t fn, void* arg) {
+    bench_handle_t h = { 0, -1 };
+    if (bench_use_tasks) h.task = task_spawn(fn, arg);
+    else h.pid = ppt_spawn(fn, arg);
+    return h;
+}
+
+static void bench_join_job(bench_handle_t h) {
+    if (bench_use_tasks) task_join(h.task);
+    else ppt_join(h.pid);
+}
+
+/* fib */
+typedef struct {
+    int n;
+    int result;
+} fib_arg_t;
+
+static int fib_serial(int n) {
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+static void fib_job(void* a) {
+    fib_arg_t* f = (fib_arg_t*)a;
+    if (f->n < FIB_CUTOFF) {
+        f->result = fib_serial(f->n);
+        return;
+    }
+
+    fib_arg_t x = { f->n - 1, 0 };
+    fib_arg_t y = { f->n - 2, 0 };
+    bench_handle_t h = bench_spawn_job(fib_job, &x);
+    fib_job(&y);
+    bench_join_job(h);
+    f->result = x.result + y.result;
+}
+
+/* quicksort */
+static int qs_data[QS_N];
+
+typedef struct {
+    int lo, hi;     /* [lo, hi] inclusive */
+} qs_arg_t;
+
+static void qs_fill(void) {
+    uint32_t seed = 12345;
+    for (int i = 0; i < QS_N; i++) {
+        seed = seed * 1103515245 + 12345;
+        qs_data[i] = (int)((seed >> 8) & 0xFFFF);
+    }
+}
+
+static int qs_sorted(void) {
+    for (int i = 1; i < QS_N; i++) {
+        if (qs_data[i - 1] > qs_data[i]) return 0;
+    }
+    return 1;
+}
+
+static int qs_partition(int lo, int hi) {
+    int pivot = qs_data[lo + (hi - lo) / 2];
+    int i = lo - 1;
+    int j = hi + 1;
+
+    for (;;) {
+        do i++; while (qs_data[i] < pivot);
+        do j--; while (qs_data[j] > pivot);
+        if (i >= j) return j;
+        int t = qs_data[i];
+        qs_data[i] = qs_data[j];
+        qs_data[j] = t;
+    }
+}
+
+static void qs_serial(int lo, int hi) {
+    while (lo < hi) {
+        int p = qs_partition(lo, hi);
+        qs_serial(lo, p);
+        lo = p + 1;
+    }
+}
+
+static void qs_job(void* a) {
+    qs_arg_t* r = (qs_arg_t*)a;
+    if (r->hi - r->lo < QS_GRAIN) {
+        qs_serial(r->lo, r->hi);
+        return;
+    }
+
+    int p = qs_partition(r->lo, r->hi);
+    qs_arg_t left = { r->lo, p };
+    qs_arg_t right = { p + 1, r->hi };
+    bench_handle_t h = bench_spawn_job(qs_job, &left);
+    qs_job(&right);
+    bench_join_job(h);
+}
+
+/* Run a root job on one backend from the null process */
+static uint32_t tasks_time(int use_tasks, task_fn_t fn, void* arg) {
+    bench_use_tasks = use_tasks;
+    uint64_t t0 = rdtsc();
+    if (use_tasks) {
+        task_run(fn, arg);
+    } else {
+        ppt_spawn(fn, arg);
+        while (get_ready_process() != 0)
+            schedule();
+    }
+    return (uint32_t)(rdtsc() - t0);
+}
+
+/* Total time, plus the cost over serial per unit of spawned work */
+static void tasks_report(const char* name, uint32_t cycles, int ok,
+                         uint32_t serial, uint32_t spawned) {
+    console_puts(name);
+    if (!ok) {
+        console_puts("FAILED\n");
+        return;
+    }
+    console_putint(cycles / 1000);
+    console_puts(" kcycles");
+    if (spawned) {
+        console_puts(", ");
+        console_putint(cycles > serial ? (cycles - serial) / spawned : 0);
+        console_puts(" cycles/spawn");
+    }
+    console_puts("\n");
+}
+
+void bench_tasks(void) {
+    task_stats_t before, after;
+    fib_arg_t fib = { FIB_N, 0 };
+    qs_arg_t qs = { 0, QS_N - 1 };
+    int expect = fib_serial(FIB_N);
+
+    scheduler_init(1);
+    scheduler_set_verbose(0);
+
+    console_puts("fib("); console_putint(FIB_N); console_puts("), cutoff ");
+    console_putint(FIB_CUTOFF); console_puts(":\n");
+    uint64_t t0 = rdtsc();
+    fib_serial(FIB_N);
+    uint32_t serial = (uint32_t)(rdtsc() - t0);
+    tasks_report("  serial:           ", serial, 1, 0, 0);
+
+    ppt_created = ppt_inlined = 0;
+    uint32_t cycles = tasks_time(0, fib_job, &fib);
+    tasks_report("  process per task: ", cycles, fib.result == expect,
+                 serial, ppt_created);
+    console_puts("    processes="); console_putint(ppt_created);
+    console_puts(" inline (table full)="); console_putint(ppt_inlined);
+    console_puts("\n");
+
+    fib.result = 0;
+    task_get_stats(&before);
+    cycles = tasks_time(1, fib_job, &fib);
+    task_get_stats(&after);
+    tasks_report("  task runtime:     ", cycles, fib.result == expect,
+                 serial, after.spawned - before.spawned);
+    console_puts("    tasks="); console_putint(after.spawned - before.spawned);
+    console_puts(" steals="); console_putint(after.steals - before.steals);
+    console_puts(" inline="); console_putint(after.inlined - before.inlined);
+    console_puts("\n");
+
+    console_puts("quicksort "); console_putint(QS_N); console_puts(" ints:\n");
+    qs_fill();
+    t0 = rdtsc();
+    qs_serial(0, QS_N - 1);
+    serial = (uint32_t)(rdtsc() - t0);
+    tasks_report("  serial:           ", serial, qs_sorted(), 0, 0);
+
+    qs_fill();
+    ppt_created = ppt_inlined = 0;
+    cycles = tasks_time(0, qs_job, &qs);
+    tasks_report("  process per task: ", cycles, qs_sorted(), serial, ppt_created);
+    console_puts("    processes="); console_putint(ppt_created);
+    console_puts(" inline (table full)="); console_putint(ppt_inlined);
+    console_puts("\n");
+
+    qs_fill();
+    task_get_stats(&before);
+    cycles = tasks_time(1, qs_job, &qs);
+    task_get_stats(&after);
+    tasks_report("  task runtime:     ", cycles, qs_sorted(),
+                 serial, after.spawned - before.spawned);
+    console_puts("    tasks="); console_putint(after.spawned - before.spawned);
+    console_puts(" steals="); console_putint(after.steals - before.steals);
+    console_puts("\n");
+
+    scheduler_set_verbose(1);
+}
+
+/* =========================
+   ELF spawn: demand vs eager
+   ========================= */
+#define SPAWN_ROUNDS 8
+
+static void spawn_run(const char* name, int flags, uint32_t khz) {
+    elf_stats_t before, after;
+    uint32_t spawn_cycles = 0;
+    uint32_t total_cycles = 0;
+
+    elf_get_stats(&before);
+    for (int i = 0; i < SPAWN_ROUNDS; i++) {
+        uint64_t t0 = rdtsc();
+        int pid = elf_spawn("big.elf", flags);
+        uint64_t t1 = rdtsc();
+        if (pid < 0) {
+            console_puts(name); console_puts("spawn FAILED\n");
+            return;
+        }
+        while (get_process_by_pid(pid) != 0) schedule();
+        spawn_cycles += (uint32_t)(t1 - t0);
+        total_cycles += (uint32_t)(rdtsc() - t0);
+    }
+    elf_get_stats(&after);
+
+    console_puts(name);
+    console_putint(spawn_cycles / SPAWN_ROUNDS);
+    console_puts(" cycles spawn, ");
+    console_putint(total_cycles / SPAWN_ROUNDS);
+    console_puts(" spawn+run (");
+    console_putint(khz ? total_cycles / SPAWN_ROUNDS / (khz / 1000) : 0);
+    console_puts(" us), ");
+    console_putint((after.pages_loaded - before.pages_loaded) / SPAWN_ROUNDS);
+    console_puts(" pages loaded\n");
+}
+
+void bench_spawn(void) {
+    vfs_stat_t st;
+    if (vfs_stat("big.elf", &st) < 0) {
+        console_puts("bench spawn: big.elf not in the initrd\n");
+        return;
+    }
+    uint32_t khz = tsc_khz();
+
+    console_puts("big.elf: "); console_putint(st.size); console_puts(" bytes\n");
+    scheduler_set_verbose(0);
+    spawn_run("demand paging: ", 0, khz);
+    spawn_run("eager load:    ", ELF_EAGER, khz);
+    scheduler_set_verbose(1);
+}
@@ -0,0 +1,27 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/* Benchmarks, run from the null-process shell ("bench <name>") */
+
+/* call/reply fast path vs queued send + schedule + recv */
+void bench_ipc(void);
+
+/* VGA framebuffer writes vs UART, characters per second */
+void bench_console(void);
+
+/* initrd read throughput: zero-copy vfs_read vs copying reads */
+void bench_vfs(void);
+
+/* kmalloc/kfree cost; compare a normal and a HEAP_DEBUG build */
+void bench_heap(void);
+
+/* futex mutex vs ipc_call lock server; shm ring vs IPC port */
+void bench_sync(void);
+
+/* recursive fib/quicksort: serial, process per task, task runtime */
+void bench_tasks(void);
+
+/* ELF spawn + run: demand paging vs loading every page up front */
+void bench_spawn(void);
+
+#endif
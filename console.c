@@ -0,0 +1,102 @@
+/* console.c - Console output fan-out (serial, VGA) */
+#include "console.h"
+#include "serial.h"
+#include "string.h"
+#include "vga.h"
+
+typedef struct {
+    const char* name;
+    void (*write)(const char*, uint32_t);
+    log_level_t level;
+} console_backend_t;
+
+static console_backend_t consoles[MAX_CONSOLES];
+static int console_count;
+
+/* UART backend: the driver is byte-at-a-time */
+static void serial_write(const char* str, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++)
+        serial_putc(str[i]);
+}
+
+void console_init(void) {
+    console_count = 0;
+
+    vga_init();
+    console_register("serial", serial_write, LOG_DEBUG);
+    console_register("vga", vga_write, LOG_DEBUG);
+}
+
+int console_register(const char* name, void (*write)(const char*, uint32_t),
+                     log_level_t level) {
+    if (console_count >= MAX_CONSOLES)
+        return -1;
+
+    consoles[console_count].name = name;
+    consoles[console_count].write = write;
+    consoles[console_count].level = level;
+    return console_count++;
+}
+
+void console_set_level(const char* name, log_level_t level) {
+    for (int i = 0; i < console_count; i++) {
+        if (strcmp(consoles[i].name, name) == 0)
+            consoles[i].level = level;
+    }
+}
+
+/* =========================
+   Leveled output
+   ========================= */
+void console_write(log_level_t level, const char* str, uint32_t len) {
+    for (int i = 0; i < console_count; i++) {
+        if (level >= consoles[i].level)
+            consoles[i].write(str, len);
+    }
+}
+
+void console_log(log_level_t level, const char* str) {
+    console_write(level, str, strlen(str));
+}
+
+void console_log_int(log_level_t level, int v) {
+    char buf[12];
+    int i = sizeof(buf);
+    int neg = v < 0;
+    uint32_t n = neg ? -(uint32_t)v : (uint32_t)v;
+
+    do {
+        buf[--i] = '0' + (n % 10);
+        n /= 10;
+    } while (n > 0);
+    if (neg) buf[--i] = '-';
+
+    console_write(level, buf + i, sizeof(buf) - i);
+}
+
+void console_log_hex(log_level_t level, uint32_t v) {
+    static const char digits[] = "0123456789abcdef";
+    char buf[10];
+
+    buf[0] = '0';
+    buf[1] = 'x';
+    for (int i = 0; i < 8; i++)
+        buf[2 + i] = digits[(v >> (28 - 4 * i)) & 0xF];
+
+    console_write(level, buf, sizeof(buf));
+}
+
+/* =========================
+   Regular output
+   ========================= */
+void console_putc(char c) {
+    console_write(LOG_INFO, &c, 1);
+}
+
+void console_puts(const char* str) {
+    console_log(LOG_INFO, str);
+}
+
+void console_putint(int v) {
+    console_log_int(LOG_INFO, v);
+}
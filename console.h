@@ -0,0 +1,36 @@
+/* console.h - Console output fan-out (serial, VGA) */
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "types.h"
+
+/* Log levels; each backend drops messages below its own level */
+typedef enum {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR
+} log_level_t;
+
+#define MAX_CONSOLES 4
+
+/* Register the serial and VGA backends */
+void console_init(void);
+
+/* Add a backend; write() receives whole strings, not single bytes */
+int console_register(const char* name, void (*write)(const char*, uint32_t),
+                     log_level_t level);
+void console_set_level(const char* name, log_level_t level);
+
+/* Leveled output */
+void console_write(log_level_t level, const char* str, uint32_t len);
+void console_log(log_level_t level, const char* str);
+void console_log_int(log_level_t level, int v);
+void console_log_hex(log_level_t level, uint32_t v);
+
+/* Regular (LOG_INFO) output */
+void console_putc(char c);
+void console_puts(const char* str);
+void console_putint(int v);
+
+#endif
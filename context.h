@@ -0,0 +1,25 @@
+/* context.h - Cooperative context switching */
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "types.h"
+
+/* Switch stacks; returns the `value` passed by whoever switches back */
+int context_switch(uint32_t* save, uint32_t next, int value);
+
+/* Build an initial frame so the first switch to it "returns" into start() */
+static inline uint32_t context_init(void* stack_top, void (*start)(void)) {
+    uint32_t* sp = (uint32_t*)stack_top;
+
+    *--sp = 0;                  /* start() must never return */
+    *--sp = (uint32_t)start;    /* return address for context_switch */
+    *--sp = 0;                  /* ebp */
+    *--sp = 0;                  /* ebx */
+    *--sp = 0;                  /* esi */
+    *--sp = 0;                  /* edi */
+    *--sp = 0x002;              /* eflags: IF clear until an IDT exists */
+
+    return (uint32_t)sp;
+}
+
+#endif
@@ -0,0 +1,301 @@
+/* elf.c - ELF32 program loader with demand paging */
+#include "elf.h"
+#include "paging.h"
+#include "memory.h"
+#include "string.h"
+#include "vfs.h"
+#include "console.h"
+#include "kapi.h"
+
+/* =========================
+   ELF32 on-disk structures
+   ========================= */
+typedef struct {
+    uint8_t  e_ident[16];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint32_t e_entry;
+    uint32_t e_phoff;
+    uint32_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+} elf32_ehdr_t;
+
+typedef struct {
+    uint32_t p_type;
+    uint32_t p_offset;
+    uint32_t p_vaddr;
+    uint32_t p_paddr;
+    uint32_t p_filesz;
+    uint32_t p_memsz;
+    uint32_t p_flags;
+    uint32_t p_align;
+} elf32_phdr_t;
+
+#define ET_EXEC   2
+#define EM_386    3
+#define PT_LOAD   1
+#define PF_W      0x2
+
+typedef struct {
+    uint32_t vaddr;
+    uint32_t memsz;
+    uint32_t filesz;
+    uint32_t offset;
+    uint32_t flags;
+} elf_segment_t;
+
+struct elf_image {
+    const uint8_t* data;        /* file image, in place in the initrd */
+    uint32_t size;
+    uint32_t entry;
+    elf_segment_t segs[ELF_MAX_SEGMENTS];
+    int nsegs;
+    uint32_t lo, hi;            /* page-aligned span of all segments */
+    uint32_t* frames;           /* shared read-only frame per page, 0 = not loaded */
+    int refs;
+};
+
+static elf_image_t images[MAX_ELF_IMAGES];
+static elf_stats_t stats;
+
+/* =========================
+   Image cache
+   ========================= */
+static int elf_parse(elf_image_t* img, const uint8_t* data, uint32_t size) {
+    const elf32_ehdr_t* eh = (const elf32_ehdr_t*)data;
+
+    if (size < sizeof(elf32_ehdr_t) ||
+        eh->e_ident[0] != 0x7F || eh->e_ident[1] != 'E' ||
+        eh->e_ident[2] != 'L' || eh->e_ident[3] != 'F' ||
+        eh->e_ident[4] != 1 ||          /* 32-bit */
+        eh->e_ident[5] != 1 ||          /* little endian */
+        eh->e_type != ET_EXEC || eh->e_machine != EM_386 ||
+        eh->e_phentsize != sizeof(elf32_phdr_t) ||
+        eh->e_phoff + eh->e_phnum * sizeof(elf32_phdr_t) > size)
+        return -1;
+
+    img->nsegs = 0;
+    img->lo = USER_END;
+    img->hi = USER_BASE;
+
+    const elf32_phdr_t* ph = (const elf32_phdr_t*)(data + eh->e_phoff);
+    for (int i = 0; i < eh->e_phnum; i++) {
+        if (ph[i].p_type != PT_LOAD || ph[i].p_memsz == 0)
+            continue;
+
+        uint32_t end = ph[i].p_vaddr + ph[i].p_memsz;
+        if (img->nsegs >= ELF_MAX_SEGMENTS ||
+            ph[i].p_filesz > ph[i].p_memsz ||
+            ph[i].p_offset + ph[i].p_filesz > size ||
+            ph[i].p_vaddr < USER_BASE || end > SHM_BASE || end < ph[i].p_vaddr)
+            return -1;
+
+        elf_segment_t* seg = &img->segs[img->nsegs++];
+        seg->vaddr = ph[i].p_vaddr;
+        seg->memsz = ph[i].p_memsz;
+        seg->filesz = ph[i].p_filesz;
+        seg->offset = ph[i].p_offset;
+        seg->flags = ph[i].p_flags;
+
+        if ((seg->vaddr & ~(PAGE_SIZE - 1)) < img->lo)
+            img->lo = seg->vaddr & ~(PAGE_SIZE - 1);
+        if (((end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1)) > img->hi)
+            img->hi = (end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    }
+
+    if (img->nsegs == 0 || eh->e_entry < img->lo || eh->e_entry >= img->hi)
+        return -1;
+
+    img->data = data;
+    img->size = size;
+    img->entry = eh->e_entry;
+    return 0;
+}
+
+/* Find or create the image for a file; returns it with a reference held */
+static elf_image_t* elf_acquire(const uint8_t* data, uint32_t size) {
+    elf_image_t* free_slot = 0;
+
+    for (int i = 0; i < MAX_ELF_IMAGES; i++) {
+        if (images[i].refs > 0 && images[i].data == data) {
+            images[i].refs++;
+            return &images[i];
+        }
+        if (images[i].refs == 0 && !free_slot)
+            free_slot = &images[i];
+    }
+
+    if (!free_slot || elf_parse(free_slot, data, size) < 0)
+        return 0;
+
+    uint32_t pages = (free_slot->hi - free_slot->lo) / PAGE_SIZE;
+    free_slot->frames = (uint32_t*)kmalloc(pages * sizeof(uint32_t));
+    if (!free_slot->frames)
+        return 0;
+    memset(free_slot->frames, 0, pages * sizeof(uint32_t));
+
+    free_slot->refs = 1;
+    return free_slot;
+}
+
+void elf_release(elf_image_t* img) {
+    if (!img || img->refs <= 0 || --img->refs > 0)
+        return;
+
+    /* Last user gone: return the shared text frames */
+    uint32_t pages = (img->hi - img->lo) / PAGE_SIZE;
+    for (uint32_t i = 0; i < pages; i++)
+        frame_free(img->frames[i]);
+    kfree(img->frames);
+    img->frames = 0;
+    img->data = 0;
+}
+
+/* =========================
+   Page loading
+   ========================= */
+static void elf_fill_page(elf_image_t* img, uint32_t page, uint32_t frame) {
+    memset((void*)frame, 0, PAGE_SIZE);    /* .bss and gaps read as zero */
+
+    for (int i = 0; i < img->nsegs; i++) {
+        elf_segment_t* seg = &img->segs[i];
+        uint32_t start = seg->vaddr > page ? seg->vaddr : page;
+        uint32_t end = seg->vaddr + seg->filesz;
+        if (end > page + PAGE_SIZE)
+            end = page + PAGE_SIZE;
+
+        if (start < end) {
+            memcpy((void*)(frame + (start - page)),
+                   img->data + seg->offset + (start - seg->vaddr),
+                   end - start);
+        }
+    }
+    stats.pages_loaded++;
+}
+
+int elf_fault(process_t* p, uint32_t addr) {
+    elf_image_t* img = p->image;
+    uint32_t page = addr & ~(PAGE_SIZE - 1);
+
+    if (!img || page < img->lo || page >= img->hi)
+        return -1;
+    if (paging_is_mapped(p->page_dir, page))
+        return 0;
+
+    /* Which segments cover this page, and may any of them be written? */
+    int found = 0;
+    int writable = 0;
+    for (int i = 0; i < img->nsegs; i++) {
+        elf_segment_t* seg = &img->segs[i];
+        if (seg->vaddr < page + PAGE_SIZE && seg->vaddr + seg->memsz > page) {
+            found = 1;
+            if (seg->flags & PF_W) writable = 1;
+        }
+    }
+    if (!found)
+        return -1;
+
+    /* Read-only: one frame per image page, shared by all processes */
+    if (!writable) {
+        uint32_t* slot = &img->frames[(page - img->lo) / PAGE_SIZE];
+        if (!*slot) {
+            uint32_t frame = frame_alloc();
+            if (!frame)
+                return -1;
+            elf_fill_page(img, page, frame);
+            *slot = frame;
+        } else {
+            stats.pages_shared++;
+        }
+        return paging_map(p->page_dir, page, *slot, PAGE_SHARED);
+    }
+
+    /* Writable: private copy */
+    uint32_t frame = frame_alloc();
+    if (!frame)
+        return -1;
+    elf_fill_page(img, page, frame);
+    if (paging_map(p->page_dir, page, frame, PAGE_WRITE) < 0) {
+        frame_free(frame);
+        return -1;
+    }
+    return 0;
+}
+
+/* =========================
+   Process creation
+   ========================= */
+static int elf_getpid(void) {
+    return get_current_process()->pid;
+}
+
+static const kapi_t kapi = {
+    console_puts,
+    console_putint,
+    elf_getpid,
+};
+
+/* Kernel-side entry: runs with the process's page directory active,
+   so the first instruction fetch faults the entry page in */
+static void elf_start(void) {
+    process_t* p = get_current_process();
+    ((void (*)(const kapi_t*))p->image->entry)(&kapi);
+}
+
+int elf_spawn(const char* path, int flags) {
+    vfs_stat_t st;
+    const void* data;
+
+    /* The file is used in place: no copy out of the initrd */
+    if (vfs_stat(path, &st) < 0)
+        return -1;
+    int fd = vfs_open(path);
+    if (fd < 0)
+        return -1;
+    int n = vfs_read(fd, &data, st.size);
+    vfs_close(fd);
+    if (n != (int)st.size)
+        return -1;
+
+    elf_image_t* img = elf_acquire((const uint8_t*)data, st.size);
+    if (!img)
+        return -1;
+
+    uint32_t dir = paging_create_dir();
+    int pid = dir ? process_create(elf_start) : -1;
+    process_t* p = get_process_by_pid(pid);
+    if (!p) {
+        paging_destroy_dir(dir);
+        elf_release(img);
+        return -1;
+    }
+    p->page_dir = dir;
+    p->image = img;
+
+    if (flags & ELF_EAGER) {
+        for (int i = 0; i < img->nsegs; i++) {
+            elf_segment_t* seg = &img->segs[i];
+            uint32_t page = seg->vaddr & ~(PAGE_SIZE - 1);
+            for (; page < seg->vaddr + seg->memsz; page += PAGE_SIZE) {
+                if (elf_fault(p, page) < 0) {
+                    process_terminate(pid);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    stats.spawned++;
+    return pid;
+}
+
+void elf_get_stats(elf_stats_t* out) {
+    *out = stats;
+}
@@ -0,0 +1,35 @@
+/* elf.h - ELF32 program loader with demand paging */
+#ifndef ELF_H
+#define ELF_H
+
+#include "types.h"
+#include "process.h"
+
+#define MAX_ELF_IMAGES   8
+#define ELF_MAX_SEGMENTS 8
+
+/* elf_spawn flags */
+#define ELF_EAGER  0x1      /* load every page up front (no demand paging) */
+
+typedef struct elf_image elf_image_t;
+
+typedef struct {
+    uint32_t spawned;
+    uint32_t pages_loaded;  /* frames filled from the file */
+    uint32_t pages_shared;  /* read-only pages mapped from the image cache */
+} elf_stats_t;
+
+/* Create a process from an ELF32 executable in the VFS.
+   Segments are mapped lazily on page fault; read-only pages are
+   shared by every process running the same image. */
+int elf_spawn(const char* path, int flags);
+
+/* Page-fault hook: map the page holding addr for p (0 on success) */
+int elf_fault(process_t* p, uint32_t addr);
+
+/* Drop a process's reference to its image */
+void elf_release(elf_image_t* img);
+
+void elf_get_stats(elf_stats_t* out);
+
+#endif
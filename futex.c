@@ -0,0 +1,108 @@
+/* futex.c - Sleep/wake on a memory word
+   Waiters hang off a small hash of FIFO queues keyed by the physical
+   address of the word, so the same shared page mapped anywhere in two
+   address spaces meets in one queue. */
+#include "futex.h"
+#include "scheduler.h"
+#include "paging.h"
+#include "shm.h"
+#include "cpu.h"
+
+typedef struct {
+    process_t* head;
+    process_t* tail;
+} futex_queue_t;
+
+static futex_queue_t buckets[FUTEX_BUCKETS];
+
+static uint32_t futex_key(volatile int* addr) {
+    /* Shared windows resolve without the caller's page directory, so
+       the null process (which has none) meets the same queue */
+    uint32_t key = shm_translate((uint32_t)addr);
+    if (key)
+        return key;
+
+    process_t* p = get_current_process();
+    return paging_translate(p ? p->page_dir : 0, (uint32_t)addr);
+}
+
+static futex_queue_t* futex_bucket(uint32_t key) {
+    return &buckets[(key >> 2) % FUTEX_BUCKETS];
+}
+
+/* Unlink p (whose predecessor is prev) from q */
+static void futex_unlink(futex_queue_t* q, process_t* prev, process_t* p) {
+    if (prev) prev->futex_next = p->futex_next;
+    else q->head = p->futex_next;
+    if (q->tail == p) q->tail = prev;
+    p->futex_next = 0;
+    p->futex_key = 0;
+}
+
+int futex_wait(volatile int* addr, int expected) {
+    process_t* p = get_current_process();
+    if (!scheduler_can_block())
+        return -1;
+
+    uint32_t key = futex_key(addr);
+    if (!key)
+        return -1;
+
+    /* Check-and-sleep with interrupts off so a wake cannot slip in */
+    uint32_t flags = irq_save();
+    if (*addr != expected) {
+        irq_restore(flags);
+        return -1;
+    }
+
+    futex_queue_t* q = futex_bucket(key);
+    p->futex_key = key;
+    p->futex_next = 0;
+    if (q->tail) q->tail->futex_next = p;
+    else q->head = p;
+    q->tail = p;
+
+    scheduler_block(0);
+    irq_restore(flags);
+    return 0;
+}
+
+int futex_wake(volatile int* addr, int n) {
+    uint32_t key = futex_key(addr);
+    if (!key || n <= 0)
+        return 0;
+
+    uint32_t flags = irq_save();
+    futex_queue_t* q = futex_bucket(key);
+    process_t* prev = 0;
+    process_t* p = q->head;
+    int woken = 0;
+
+    while (p && woken < n) {
+        process_t* next = p->futex_next;
+        if (p->futex_key == key) {
+            futex_unlink(q, prev, p);
+            scheduler_wake(p, 0);
+            woken++;
+        } else {
+            prev = p;
+        }
+        p = next;
+    }
+    irq_restore(flags);
+    return woken;
+}
+
+void futex_cancel(process_t* p) {
+    if (!p->futex_key)
+        return;
+
+    futex_queue_t* q = futex_bucket(p->futex_key);
+    process_t* prev = 0;
+    for (process_t* w = q->head; w; prev = w, w = w->futex_next) {
+        if (w == p) {
+            futex_unlink(q, prev, p);
+            return;
+        }
+    }
+}
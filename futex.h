@@ -0,0 +1,20 @@
+/* futex.h - Sleep/wake on a memory word */
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include "types.h"
+#include "process.h"
+
+#define FUTEX_BUCKETS 16
+
+/* Sleep while *addr == expected. Returns 0 once woken, -1 if the value
+   had already changed or the caller cannot block. */
+int futex_wait(volatile int* addr, int expected);
+
+/* Wake up to n processes sleeping on addr; returns how many woke */
+int futex_wake(volatile int* addr, int n);
+
+/* Drop p from any futex queue (process termination) */
+void futex_cancel(process_t* p);
+
+#endif
@@ -0,0 +1,69 @@
+/* idt.c - Interrupt descriptor table (CPU exceptions) */
+#include "idt.h"
+#include "console.h"
+
+#define IDT_ENTRIES   256
+#define IDT_INT_GATE  0x8E      /* present, ring 0, 32-bit interrupt gate */
+
+typedef struct {
+    uint16_t offset_low;
+    uint16_t selector;
+    uint8_t  zero;
+    uint8_t  type;
+    uint16_t offset_high;
+} __attribute__((packed)) idt_entry_t;
+
+typedef struct {
+    uint16_t limit;
+    uint32_t base;
+} __attribute__((packed)) idt_ptr_t;
+
+extern uint32_t isr_table[IDT_EXCEPTIONS];
+
+static idt_entry_t idt[IDT_ENTRIES];
+static isr_handler_t handlers[IDT_EXCEPTIONS];
+
+static void idt_set_gate(int n, uint32_t handler) {
+    idt[n].offset_low = handler & 0xFFFF;
+    idt[n].selector = KERNEL_CS;
+    idt[n].zero = 0;
+    idt[n].type = IDT_INT_GATE;
+    idt[n].offset_high = handler >> 16;
+}
+
+void idt_init(void) {
+    for (int i = 0; i < IDT_EXCEPTIONS; i++)
+        idt_set_gate(i, isr_table[i]);
+
+    idt_ptr_t ptr;
+    ptr.limit = sizeof(idt) - 1;
+    ptr.base = (uint32_t)idt;
+    __asm__ volatile ("lidt %0" : : "m"(ptr));
+}
+
+void idt_set_handler(int vector, isr_handler_t handler) {
+    if (vector >= 0 && vector < IDT_EXCEPTIONS)
+        handlers[vector] = handler;
+}
+
+/* =========================
+   Common exception entry
+   ========================= */
+void isr_dispatch(isr_regs_t* regs) {
+    if (regs->vector < IDT_EXCEPTIONS && handlers[regs->vector]) {
+        handlers[regs->vector](regs);
+        return;
+    }
+
+    /* Unhandled exception: report and stop */
+    console_log(LOG_ERROR, "\nKernel panic: exception ");
+    console_log_int(LOG_ERROR, regs->vector);
+    console_log(LOG_ERROR, " error=");
+    console_log_hex(LOG_ERROR, regs->error);
+    console_log(LOG_ERROR, " eip=");
+    console_log_hex(LOG_ERROR, regs->eip);
+    console_log(LOG_ERROR, "\n");
+    for (;;) {
+        __asm__ volatile ("cli; hlt");
+    }
+}
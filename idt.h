@@ -0,0 +1,24 @@
+/* idt.h - Interrupt descriptor table (CPU exceptions) */
+#ifndef IDT_H
+#define IDT_H
+
+#include "types.h"
+
+#define KERNEL_CS 0x08
+
+#define IDT_EXCEPTIONS 32
+#define EXC_PAGE_FAULT 14
+
+/* Frame built by isr.S (pusha order, then vector/error, then CPU frame) */
+typedef struct {
+    uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax;
+    uint32_t vector, error;
+    uint32_t eip, cs, eflags;
+} isr_regs_t;
+
+typedef void (*isr_handler_t)(isr_regs_t* regs);
+
+void idt_init(void);
+void idt_set_handler(int vector, isr_handler_t handler);
+
+#endif
@@ -0,0 +1,180 @@
+#include "initrd.h"
+#include "string.h"
+
+static initrd_file_t files[MAX_INITRD_FILES];
+static int file_count;
+
+/* =========================
+   Helpers
+   ========================= */
+static uint32_t parse_octal(const char* s, int len) {
+    uint32_t v = 0;
+    for (int i = 0; i < len && s[i] >= '0' && s[i] <= '7'; i++)
+        v = (v << 3) | (s[i] - '0');
+    return v;
+}
+
+static uint32_t parse_hex(const char* s, int len) {
+    uint32_t v = 0;
+    for (int i = 0; i < len; i++) {
+        char c = s[i];
+        uint32_t d;
+        if (c >= '0' && c <= '9') d = c - '0';
+        else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
+        else break;
+        v = (v << 4) | d;
+    }
+    return v;
+}
+
+/* Record a regular file; names are stored without a leading "./" or "/".
+   Names that do not fit in INITRD_NAME_LEN are skipped rather than
+   stored truncated (and thus under the wrong name). */
+static void add_file(const char* name, int name_len, const uint8_t* data,
+                     uint32_t size) {
+    if (file_count >= MAX_INITRD_FILES)
+        return;
+
+    for (;;) {
+        if (name_len >= 2 && name[0] == '.' && name[1] == '/') {
+            name += 2;
+            name_len -= 2;
+        } else if (name_len >= 1 && name[0] == '/') {
+            name++;
+            name_len--;
+        } else {
+            break;
+        }
+    }
+    if (name_len <= 0 || !*name)
+        return;
+
+    int len = 0;
+    while (len < name_len && name[len])
+        len++;
+    if (len >= INITRD_NAME_LEN)
+        return;
+
+    initrd_file_t* f = &files[file_count++];
+    for (int n = 0; n < len; n++)
+        f->name[n] = name[n];
+    f->name[len] = '\0';
+    f->data = data;
+    f->size = size;
+}
+
+/* =========================
+   ustar
+   ========================= */
+#define TAR_BLOCK      512
+#define TAR_NAME_LEN   100
+#define TAR_PREFIX_LEN 155
+
+static void parse_tar(const uint8_t* base, uint32_t size) {
+    uint32_t off = 0;
+
+    while (off + TAR_BLOCK <= size) {
+        const char* hdr = (const char*)(base + off);
+        if (hdr[0] == '\0')
+            break;  /* end-of-archive block */
+
+        uint32_t fsize = parse_octal(hdr + 124, 12);
+        char type = hdr[156];
+        const uint8_t* data = base + off + TAR_BLOCK;
+
+        /* Compared by subtraction: a huge octal size must not wrap */
+        if (fsize > size - off - TAR_BLOCK)
+            break;
+
+        if (type == '0' || type == '\0') {
+            /* POSIX ustar splits long paths: prefix "/" name. (GNU
+               "ustar  " headers use that area for other fields.) */
+            if (strncmp(hdr + 257, "ustar", 6) == 0 && hdr[345]) {
+                char path[TAR_PREFIX_LEN + 1 + TAR_NAME_LEN + 1];
+                int n = 0;
+                for (int i = 0; i < TAR_PREFIX_LEN && hdr[345 + i]; i++)
+                    path[n++] = hdr[345 + i];
+                path[n++] = '/';
+                for (int i = 0; i < TAR_NAME_LEN && hdr[i]; i++)
+                    path[n++] = hdr[i];
+                add_file(path, n, data, fsize);
+            } else {
+                add_file(hdr, TAR_NAME_LEN, data, fsize);
+            }
+        }
+
+        off += TAR_BLOCK + ((fsize + TAR_BLOCK - 1) & ~(TAR_BLOCK - 1));
+    }
+}
+
+/* =========================
+   cpio "newc"
+   ========================= */
+#define CPIO_HDR_LEN 110
+
+static void parse_cpio(const uint8_t* base, uint32_t size) {
+    uint32_t off = 0;
+
+    while (off + CPIO_HDR_LEN <= size &&
+           strncmp((const char*)base + off, "070701", 6) == 0) {
+        const char* hdr = (const char*)(base + off);
+        uint32_t mode = parse_hex(hdr + 14, 8);
+        uint32_t fsize = parse_hex(hdr + 54, 8);
+        uint32_t nsize = parse_hex(hdr + 94, 8);
+        const char* name = hdr + CPIO_HDR_LEN;
+
+        /* The name must lie inside the image and be NUL-terminated
+           before anything reads it */
+        if (nsize == 0 || nsize > size - off - CPIO_HDR_LEN ||
+            name[nsize - 1] != '\0')
+            break;
+
+        if (strcmp(name, "TRAILER!!!") == 0)
+            break;
+
+        uint32_t data_off = (off + CPIO_HDR_LEN + nsize + 3) & ~3;
+        if (data_off > size || fsize > size - data_off)
+            break;
+
+        if ((mode & 0170000) == 0100000)
+            add_file(name, nsize, base + data_off, fsize);
+
+        off = (data_off + fsize + 3) & ~3;
+    }
+}
+
+/* =========================
+   Public API
+   ========================= */
+int initrd_init(const void* start, uint32_t size) {
+    file_count = 0;
+    if (!start || size < 6)
+        return -1;
+
+    if (strncmp((const char*)start, "070701", 6) == 0)
+        parse_cpio((const uint8_t*)start, size);
+    else
+        parse_tar((const uint8_t*)start, size);
+
+    return file_count;
+}
+
+int initrd_count(void) {
+    return file_count;
+}
+
+const initrd_file_t* initrd_get(int index) {
+    if (index < 0 || index >= file_count) return 0;
+    return &files[index];
+}
+
+const initrd_file_t* initrd_lookup(const char* name) {
+    while (*name == '/') name++;
+
+    for (int i = 0; i < file_count; i++) {
+        if (strcmp(files[i].name, name) == 0)
+            return &files[i];
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef INITRD_H
+#define INITRD_H
+
+#include "types.h"
+
+/* Read-only initial ramdisk (ustar or cpio "newc") from a boot module.
+   File data is never copied: entries point into the module memory. */
+
+#define MAX_INITRD_FILES 64
+#define INITRD_NAME_LEN  256  /* ustar prefix + "/" + name */
+
+typedef struct {
+    char name[INITRD_NAME_LEN];
+    const uint8_t* data;
+    uint32_t size;
+} initrd_file_t;
+
+/* Parse the archive at [start, start+size); returns the file count or -1 */
+int initrd_init(const void* start, uint32_t size);
+
+int initrd_count(void);
+const initrd_file_t* initrd_get(int index);
+const initrd_file_t* initrd_lookup(const char* name);
+
+#endif
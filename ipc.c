@@ -1,27 +1,80 @@
 #include "ipc.h"
 #include "process.h"
+#include "scheduler.h"
+#include "memory.h"
+#include "string.h"
 
-/* Message queues */
+/* Call/reply blocking states kept in process_t.ipc_wait */
+#define IPC_WAIT_NONE   0
+#define IPC_WAIT_RECV   1   /* server parked in ipc_reply_wait */
+#define IPC_WAIT_CALL   2   /* caller queued while server is busy */
+#define IPC_WAIT_REPLY  3   /* caller waiting for its reply */
+#define IPC_WAIT_PORT   4   /* receiver sleeping in ipc_wait_any */
+
+/* Message queues, one ring per process table slot */
 static int msg_queue[MAX_PROCS][MAX_IPC_MSG];
+static int msg_head[MAX_PROCS];
 static int msg_count[MAX_PROCS];
+static int msg_owner[MAX_PROCS];    /* pid currently owning the slot */
+
+/* Named port registry */
+typedef struct {
+    char name[PORT_NAME_LEN];
+    int* buf;
+    int capacity;
+    int head;
+    int count;
+    int used;
+} port_t;
+
+static port_t ports[MAX_PORTS];
+static int port_waiters;            /* processes in IPC_WAIT_PORT */
 
 void ipc_init(void) {
     for (int i = 0; i < MAX_PROCS; i++) {
+        msg_head[i] = 0;
         msg_count[i] = 0;
+        msg_owner[i] = -1;
+    }
+
+    for (int i = 0; i < MAX_PORTS; i++) {
+        if (ports[i].used) kfree(ports[i].buf);
+        ports[i].used = 0;
+        ports[i].buf = 0;
+    }
+    port_waiters = 0;
+}
+
+/* =========================
+   Map a live pid to its mailbox
+   ========================= */
+static int mailbox_of(int pid) {
+    int slot = get_process_index(pid);
+    if (slot < 0)
+        return -1;  /* no such live process */
+
+    /* Slot was reused by a new process: drop stale messages */
+    if (msg_owner[slot] != pid) {
+        msg_owner[slot] = pid;
+        msg_head[slot] = 0;
+        msg_count[slot] = 0;
     }
+    return slot;
 }
 
 /* =========================
    Send message
    ========================= */
 int ipc_send(int pid, int msg) {
-    if (pid < 0 || pid >= MAX_PROCS)
+    int box = mailbox_of(pid);
+    if (box < 0)
         return -1;
 
-    if (msg_count[pid] >= MAX_IPC_MSG)
+    if (msg_count[box] >= MAX_IPC_MSG)
         return -1;  /* queue full */
 
-    msg_queue[pid][msg_count[pid]++] = msg;
+    msg_queue[box][(msg_head[box] + msg_count[box]) % MAX_IPC_MSG] = msg;
+    msg_count[box]++;
     return 0;
 }
 
@@ -29,19 +82,277 @@ int ipc_send(int pid, int msg) {
    Receive message
    ========================= */
 int ipc_recv(int pid, int* msg) {
-    if (pid < 0 || pid >= MAX_PROCS)
+    int box = mailbox_of(pid);
+    if (box < 0)
         return -1;
 
-    if (msg_count[pid] == 0)
+    if (msg_count[box] == 0)
         return -1;  /* no message */
 
-    *msg = msg_queue[pid][0];
+    *msg = msg_queue[box][msg_head[box]];
+    msg_head[box] = (msg_head[box] + 1) % MAX_IPC_MSG;
+    msg_count[box]--;
+
+    return 0;
+}
+
+/* =========================
+   Find a queued caller of server_pid
+   ========================= */
+static process_t* find_pending_caller(int server_pid) {
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        process_t* p = get_process_at_index(i);
+        if (p->state == PROC_WAITING &&
+            p->ipc_wait == IPC_WAIT_CALL &&
+            p->ipc_peer == server_pid) {
+            return p;
+        }
+    }
+    return 0;
+}
+
+/* =========================
+   Synchronous call
+   ========================= */
+int ipc_call(int pid, int msg, int* reply) {
+    process_t* self = get_current_process();
+    process_t* server = get_process_by_pid(pid);
+
+    if (!self || !server || server == self || !scheduler_can_block())
+        return -1;
+
+    self->ipc_peer = pid;
+
+    /* Fast path: server is parked in ipc_reply_wait, so switch
+       straight to it; msg travels in a register, no queue, no scan */
+    if (server->state == PROC_WAITING && server->ipc_wait == IPC_WAIT_RECV) {
+        server->ipc_wait = IPC_WAIT_NONE;
+        server->ipc_peer = self->pid;
+        self->ipc_wait = IPC_WAIT_REPLY;
+        if (scheduler_handoff(server, msg, reply) < 0)
+            return -1;
+        return self->ipc_peer < 0 ? -1 : 0;
+    }
+
+    /* Slow path: park the message and sleep until the server replies */
+    self->ipc_wait = IPC_WAIT_CALL;
+    self->ipc_msg = msg;
+    server->ipc_pending++;
+    scheduler_block(reply);
+
+    /* ipc_cancel() clears ipc_peer if the server died first */
+    return self->ipc_peer < 0 ? -1 : 0;
+}
+
+/* =========================
+   Termination cleanup
+   ========================= */
+void ipc_cancel(process_t* p) {
+    /* A queued caller no longer counts against its server */
+    if (p->ipc_wait == IPC_WAIT_CALL) {
+        process_t* server = get_process_by_pid(p->ipc_peer);
+        if (server && server->ipc_pending > 0)
+            server->ipc_pending--;
+    }
+
+    /* Keep port_wake()'s early exit working */
+    if (p->ipc_wait == IPC_WAIT_PORT) {
+        port_waiters--;
+        p->ipc_ports = 0;
+    }
+
+    /* Callers queued on p or waiting for its reply get -1 */
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        process_t* c = get_process_at_index(i);
+        if (c != p && c->state == PROC_WAITING && c->ipc_peer == p->pid &&
+            (c->ipc_wait == IPC_WAIT_CALL || c->ipc_wait == IPC_WAIT_REPLY)) {
+            c->ipc_wait = IPC_WAIT_NONE;
+            c->ipc_peer = -1;
+            scheduler_wake(c, -1);
+        }
+    }
+
+    p->ipc_wait = IPC_WAIT_NONE;
+    p->ipc_peer = -1;
+    p->ipc_pending = 0;
+}
+
+/* =========================
+   Reply and wait for next call
+   ========================= */
+int ipc_reply_wait(int reply, int* msg) {
+    process_t* self = get_current_process();
+    if (!self || !scheduler_can_block())
+        return -1;
+
+    process_t* client = 0;
+    if (self->ipc_peer >= 0)
+        client = get_process_by_pid(self->ipc_peer);
+    if (client && client->ipc_wait != IPC_WAIT_REPLY)
+        client = 0;
+    self->ipc_peer = -1;
+
+    /* A caller queued while we were busy: wake the old client and
+       take the new message without switching */
+    process_t* next = self->ipc_pending ? find_pending_caller(self->pid) : 0;
+    if (next) {
+        self->ipc_pending--;
+        if (client) {
+            client->ipc_wait = IPC_WAIT_NONE;
+            scheduler_wake(client, reply);
+        }
+        next->ipc_wait = IPC_WAIT_REPLY;
+        self->ipc_peer = next->pid;
+        *msg = next->ipc_msg;
+        return next->pid;
+    }
 
-    /* shift remaining messages */
-    for (int i = 1; i < msg_count[pid]; i++) {
-        msg_queue[pid][i - 1] = msg_queue[pid][i];
+    /* Park as receiver; the next caller switches directly to us */
+    int v = 0;
+    self->ipc_wait = IPC_WAIT_RECV;
+    if (client) {
+        client->ipc_wait = IPC_WAIT_NONE;
+        scheduler_handoff(client, reply, &v);
+    } else {
+        scheduler_block(&v);
     }
-    msg_count[pid]--;
 
+    *msg = v;
+    return self->ipc_peer;
+}
+
+/* =========================
+   Port registry
+   ========================= */
+static int port_valid(int port) {
+    return port >= 0 && port < MAX_PORTS && ports[port].used;
+}
+
+int ipc_port_lookup(const char* name) {
+    for (int i = 0; i < MAX_PORTS; i++) {
+        if (ports[i].used && strcmp(ports[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int ipc_port_create(const char* name, int capacity) {
+    if (!name || capacity <= 0 || ipc_port_lookup(name) >= 0)
+        return -1;
+
+    for (int i = 0; i < MAX_PORTS; i++) {
+        if (!ports[i].used) {
+            int* buf = (int*)kmalloc(capacity * sizeof(int));
+            if (!buf)
+                return -1;
+
+            int n = 0;
+            while (name[n] && n < PORT_NAME_LEN - 1) {
+                ports[i].name[n] = name[n];
+                n++;
+            }
+            ports[i].name[n] = '\0';
+
+            ports[i].buf = buf;
+            ports[i].capacity = capacity;
+            ports[i].head = 0;
+            ports[i].count = 0;
+            ports[i].used = 1;
+            return i;
+        }
+    }
+    return -1;  /* registry full */
+}
+
+/* =========================
+   Wake receivers sleeping on a port
+   ========================= */
+static void port_wake(int port, int all) {
+    if (port_waiters == 0)
+        return;
+
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        process_t* p = get_process_at_index(i);
+        if (p->state == PROC_WAITING &&
+            p->ipc_wait == IPC_WAIT_PORT &&
+            (p->ipc_ports & (1u << port))) {
+            p->ipc_wait = IPC_WAIT_NONE;
+            port_waiters--;
+            scheduler_wake(p, 0);
+            if (!all) return;
+        }
+    }
+}
+
+void ipc_port_destroy(int port) {
+    if (!port_valid(port))
+        return;
+
+    kfree(ports[port].buf);
+    ports[port].buf = 0;
+    ports[port].used = 0;
+
+    /* Waiters re-check their ports and fail */
+    port_wake(port, 1);
+}
+
+/* =========================
+   Port send
+   ========================= */
+int ipc_port_send(int port, int msg) {
+    if (!port_valid(port))
+        return -1;
+
+    port_t* pt = &ports[port];
+    if (pt->count >= pt->capacity)
+        return -1;  /* port full */
+
+    pt->buf[(pt->head + pt->count) % pt->capacity] = msg;
+    pt->count++;
+
+    /* One message, one wakeup */
+    port_wake(port, 0);
+    return 0;
+}
+
+/* =========================
+   Wait on many ports
+   ========================= */
+int ipc_wait_any(const int* port_ids, int n) {
+    for (;;) {
+        uint32_t mask = 0;
+
+        for (int i = 0; i < n; i++) {
+            if (!port_valid(port_ids[i]))
+                return -1;
+            if (ports[port_ids[i]].count > 0)
+                return i;
+            mask |= 1u << port_ids[i];
+        }
+
+        process_t* self = get_current_process();
+        if (!mask || !self || !scheduler_can_block())
+            return -1;
+
+        /* Sleep; a sender wakes us, then re-check since another
+           receiver may have drained the port first */
+        self->ipc_wait = IPC_WAIT_PORT;
+        self->ipc_ports = mask;
+        port_waiters++;
+        scheduler_block(0);
+    }
+}
+
+/* =========================
+   Port receive
+   ========================= */
+int ipc_port_recv(int port, int* msg) {
+    if (ipc_wait_any(&port, 1) < 0)
+        return -1;
+
+    port_t* pt = &ports[port];
+    *msg = pt->buf[pt->head];
+    pt->head = (pt->head + 1) % pt->capacity;
+    pt->count--;
     return 0;
 }
@@ -2,10 +2,14 @@
 #define IPC_H
 
 #include "types.h"
+#include "process.h"
 
 #define MAX_IPC_MSG   8     /* messages per process */
 #define MAX_PROCS     MAX_PROCESSES
 
+#define MAX_PORTS     16    /* named ports (at most 32, see ipc_wait_any) */
+#define PORT_NAME_LEN 16
+
 void ipc_init(void);
 
 /* send a message to pid */
@@ -14,5 +18,28 @@ int ipc_send(int pid, int msg);
 /* receive a message for pid */
 int ipc_recv(int pid, int* msg);
 
+/* synchronous call: send msg to pid and sleep until it replies */
+int ipc_call(int pid, int msg, int* reply);
+
+/* reply to the last caller (if any), then wait for the next call.
+   Returns the caller pid and stores its message in *msg. */
+int ipc_reply_wait(int reply, int* msg);
+
+/* Process termination: fail callers still waiting on p (their
+   ipc_call returns -1) and drop p from any IPC wait state */
+void ipc_cancel(process_t* p);
+
+/* Named ports: many senders, many receivers, one shared FIFO */
+int ipc_port_create(const char* name, int capacity);
+int ipc_port_lookup(const char* name);
+void ipc_port_destroy(int port);
+
+/* send never blocks (-1 when full); recv sleeps while the port is empty */
+int ipc_port_send(int port, int msg);
+int ipc_port_recv(int port, int* msg);
+
+/* sleep until one of ports[0..n) has data; returns its index in ports[] */
+int ipc_wait_any(const int* ports, int n);
+
 #endif
 
@@ -0,0 +1,13 @@
+/* kapi.h - Kernel services handed to ELF programs
+   Programs run in ring 0 and receive this table as the only argument
+   of their entry point: void _start(const kapi_t* k) */
+#ifndef KAPI_H
+#define KAPI_H
+
+typedef struct {
+    void (*puts)(const char* str);
+    void (*putint)(int v);
+    int  (*getpid)(void);
+} kapi_t;
+
+#endif
@@ -1,68 +1,326 @@
 /* kernel.c - Main kernel with null process */
 #include "types.h"
 #include "serial.h"
+#include "console.h"
 #include "string.h"
 #include "memory.h"
 #include "process.h"
 #include "scheduler.h"
 #include "ipc.h"
+#include "bench.h"
+#include "multiboot.h"
+#include "softirq.h"
+#include "initrd.h"
+#include "vfs.h"
+#include "idt.h"
+#include "paging.h"
+#include "elf.h"
+#include "shm.h"
+#include "sync.h"
+#include "futex.h"
+#include "task.h"
 
 
 #define MAX_INPUT 128
 
-/* forward declaration for integer print helper */
-static void serial_putint(int v);
-
 /* simple test process (top-level, not nested) */
 static void test_process(void) {
-    serial_puts("Hello from test process!\n");
+    console_puts("Hello from test process!\n");
 }
 
 /* process for testing scheduler quantum */
 static void quantum_process(void) {
-    serial_puts("Quantum process executing\n");
+    console_puts("Quantum process executing\n");
 }
 
 /* IPC test processes */
+static int ipc_recv_pid;
+
 static void sender_process(void) {
-    serial_puts("Sender: sending messages...\n");
-    ipc_send(1, 100);
-    ipc_send(1, 200);
-    ipc_send(1, 300);
+    console_puts("Sender: sending messages...\n");
+    ipc_send(ipc_recv_pid, 100);
+    ipc_send(ipc_recv_pid, 200);
+    ipc_send(ipc_recv_pid, 300);
 }
 
 static void receiver_process(void) {
     int msg;
-    serial_puts("Receiver: receiving messages...\n");
+    int self = get_current_process()->pid;
+    console_puts("Receiver: receiving messages...\n");
+
+    while (ipc_recv(self, &msg) == 0) {
+        console_puts(" Received msg=");
+        console_putint(msg);
+        console_puts("\n");
+    }
+}
+
+/* IPC call/reply test processes */
+static int call_server_pid;
+
+static void call_server(void) {
+    int msg;
+    int reply = 0;
+    while (ipc_reply_wait(reply, &msg) >= 0) {
+        reply = msg * 2;
+    }
+}
 
-    while (ipc_recv(1, &msg) == 0) {
-        serial_puts(" Received msg=");
-        serial_putint(msg);
-        serial_puts("\n");
+static void call_client(void) {
+    int reply;
+    for (int i = 1; i <= 3; i++) {
+        if (ipc_call(call_server_pid, i, &reply) == 0) {
+            console_puts(" call "); console_putint(i);
+            console_puts(" -> reply="); console_putint(reply); console_puts("\n");
+        } else {
+            console_puts(" ipc_call failed\n");
+        }
     }
 }
 
-/* helper: print a non-negative integer to serial */
-static void serial_putint(int v) {
-    char buf[12];
-    int i = 0;
-    if (v == 0) {
-        buf[i++] = '0';
+/* server that never answers: its callers must fail when it dies */
+static void call_sink(void) {
+    scheduler_block(0);
+}
+
+static void call_orphan(void) {
+    int reply;
+    if (ipc_call(call_server_pid, 7, &reply) < 0)
+        console_puts(" Caller of terminated server got -1\n");
+    else
+        console_puts(" Caller of terminated server got a reply\n");
+}
+
+/* IPC port test processes */
+static int work_port;
+static int select_ports[2];
+
+static void port_worker(void) {
+    int item;
+    int self = get_current_process()->pid;
+
+    /* Pull from the shared queue until a stop item (-1) arrives */
+    while (ipc_port_recv(work_port, &item) == 0 && item >= 0) {
+        console_puts(" worker "); console_putint(self);
+        console_puts(" took item "); console_putint(item); console_puts("\n");
+        scheduler_yield();
+    }
+}
+
+static void select_process(void) {
+    int msg;
+    int idx = ipc_wait_any(select_ports, 2);
+    if (idx >= 0 && ipc_port_recv(select_ports[idx], &msg) == 0) {
+        console_puts(" wait_any woke on port index "); console_putint(idx);
+        console_puts(", msg="); console_putint(msg); console_puts("\n");
     } else {
-        int n = v;
-        char tmp[12];
-        int ti = 0;
-        while (n > 0 && ti < (int)sizeof(tmp)) {
-            tmp[ti++] = '0' + (n % 10);
-            n /= 10;
+        console_puts(" wait_any failed\n");
+    }
+}
+
+/* shared memory + futex test: one process waits on a condition
+   variable in a shared region, the other sets the flag */
+typedef struct {
+    mutex_t lock;
+    cond_t ready;
+    int flag;
+} shm_test_t;
+
+static int shm_test_id;
+static int shm_test_seen;
+
+static void shm_waiter(void) {
+    shm_test_t* t = (shm_test_t*)shm_attach(shm_test_id);
+    if (!t) return;
+    mutex_lock(&t->lock);
+    while (!t->flag)
+        cond_wait(&t->ready, &t->lock);
+    shm_test_seen = t->flag;
+    mutex_unlock(&t->lock);
+}
+
+static void shm_signaller(void) {
+    shm_test_t* t = (shm_test_t*)shm_attach(shm_test_id);
+    if (!t) return;
+    mutex_lock(&t->lock);
+    t->flag = 42;
+    cond_signal(&t->ready);
+    mutex_unlock(&t->lock);
+}
+
+/* The null process cannot sleep: contending for a lock has to run the
+   holder, and its wakes on a shared word must reach the sleepers */
+static mutex_t null_test_lock = MUTEX_INIT;
+static int null_test_woken;
+
+static void null_test_holder(void) {
+    mutex_lock(&null_test_lock);
+    scheduler_yield();
+    mutex_unlock(&null_test_lock);
+}
+
+static void null_test_sleeper(void) {
+    volatile int* w = (volatile int*)shm_attach(shm_test_id);
+    if (!w) return;
+    while (!*w)
+        futex_wait(w, 0);
+    null_test_woken = 1;
+}
+
+/* task runtime tests */
+static int task_squares[64];
+
+static void task_square(int i, void* arg) {
+    (void)arg;
+    task_squares[i] = i * i;
+}
+
+typedef struct {
+    int n;
+    int result;
+} task_fib_t;
+
+static void task_fib(void* a) {
+    task_fib_t* f = (task_fib_t*)a;
+    if (f->n < 2) {
+        f->result = f->n;
+        return;
+    }
+    task_fib_t x = { f->n - 1, 0 };
+    task_fib_t y = { f->n - 2, 0 };
+    task_t* t = task_spawn(task_fib, &x);
+    task_fib(&y);
+    task_join(t);
+    f->result = x.result + y.result;
+}
+
+/* deferred work test item */
+static int softirq_sum;
+
+static void softirq_test_work(uint32_t arg) {
+    softirq_sum += arg;
+}
+
+/* print deferred-work counters */
+static void softirq_print_stats(void) {
+    softirq_stats_t st;
+    softirq_get_stats(&st);
+    console_puts(" raised="); console_putint(st.raised);
+    console_puts(" drained="); console_putint(st.drained);
+    console_puts(" dropped="); console_putint(st.dropped);
+    console_puts(" batches="); console_putint(st.batches);
+    console_puts("\n depth="); console_putint(st.depth);
+    console_puts(" max_depth="); console_putint(st.max_depth);
+    console_puts(" avg_latency="); console_putint(st.avg_latency);
+    console_puts(" max_latency="); console_putint(st.max_latency);
+    console_puts(" cycles\n");
+}
+
+/* arena test process: many small short-lived allocations */
+static void arena_process(void) {
+    int ok = 1;
+    for (int i = 0; i < 400; i++) {
+        int* obj = (int*)kmalloc_local(24);
+        if (!obj) { ok = 0; break; }
+        obj[0] = i;
+    }
+    char* big = (char*)kmalloc_local(8192);     /* more than a chunk */
+    if (!big) ok = 0;
+    else big[8191] = 1;
+    console_puts(ok ? " Arena allocations successful, usage=" : " Arena allocation failed, usage=");
+    console_putint(get_current_process()->mem_usage);
+    console_puts(" bytes\n");
+}
+
+/* check the multiboot command line for a whitespace-separated option */
+static int cmdline_has(const char* cmdline, const char* opt) {
+    size_t n = strlen(opt);
+    while (*cmdline) {
+        if (strncmp(cmdline, opt, n) == 0 &&
+            (cmdline[n] == ' ' || cmdline[n] == '\0')) {
+            return 1;
         }
-        while (ti > 0) buf[i++] = tmp[--ti];
+        while (*cmdline && *cmdline != ' ') cmdline++;
+        while (*cmdline == ' ') cmdline++;
+    }
+    return 0;
+}
+
+/* shell: list initrd files */
+static void shell_ls(void) {
+    vfs_stat_t st;
+    for (int i = 0; vfs_readdir(i, &st) == 0; i++) {
+        console_puts("  "); console_putint(st.size);
+        console_puts("\t"); console_puts(st.name); console_puts("\n");
+    }
+}
+
+/* shell: print a file straight from the initrd image */
+static void shell_cat(const char* path) {
+    const void* data;
+    int n;
+    int fd = vfs_open(path);
+    if (fd < 0) {
+        console_puts("cat: no such file: "); console_puts(path); console_puts("\n");
+        return;
+    }
+    while ((n = vfs_read(fd, &data, 512)) > 0) {
+        console_write(LOG_INFO, (const char*)data, n);
     }
-    buf[i] = '\0';
-    serial_puts(buf);
+    vfs_close(fd);
 }
 
-void kmain(void) {
+/* shell: heap usage, fragmentation histogram and top allocation sites */
+static void shell_meminfo(void) {
+    static const char* bucket_names[HEAP_HIST_BUCKETS] = {
+        "   <64", "  <256", "   <1K", "   <4K", "  <16K", " >=16K"
+    };
+    heap_stats_t st;
+    heap_get_stats(&st);
+
+    console_puts("heap: "); console_putint(st.heap_size);
+    console_puts(" bytes, "); console_putint(st.used_blocks);
+    console_puts(" used blocks, "); console_putint(st.free_blocks);
+    console_puts(" free blocks\n");
+    console_puts(" free="); console_putint(st.free_bytes);
+    console_puts(" largest="); console_putint(st.largest_free);
+    console_puts(" fragmentation=");
+    console_putint(st.free_bytes ? 100 - st.largest_free * 100 / st.free_bytes : 0);
+    console_puts("%\n");
+
+    for (int i = 0; i < HEAP_HIST_BUCKETS; i++) {
+        console_puts(bucket_names[i]); console_puts(": ");
+        for (uint32_t j = 0; j < st.hist_blocks[i] && j < 32; j++)
+            console_putc('#');
+        console_puts(" "); console_putint(st.hist_blocks[i]);
+        console_puts(" ("); console_putint(st.hist_bytes[i]); console_puts(" bytes)\n");
+    }
+
+    if (!st.instrumented) {
+        console_puts(" (build with HEAP_DEBUG=1 for live/peak and call sites)\n");
+        return;
+    }
+    console_puts(" live="); console_putint(st.live_bytes);
+    console_puts(" peak="); console_putint(st.peak_bytes);
+    console_puts(" allocs="); console_putint(st.allocs);
+    console_puts(" frees="); console_putint(st.frees);
+    console_puts(" failed="); console_putint(st.failed);
+    console_puts(" errors="); console_putint(st.errors);
+    console_puts("\n");
+
+    heap_site_t sites[16];
+    int n = heap_get_sites(sites, 16);
+    for (int i = 0; i < n; i++) {
+        console_puts("  site "); console_log_hex(LOG_INFO, (uint32_t)sites[i].site);
+        console_puts(" allocs="); console_putint(sites[i].allocs);
+        console_puts(" frees="); console_putint(sites[i].frees);
+        console_puts(" bytes="); console_putint(sites[i].bytes);
+        console_puts(" live="); console_putint(sites[i].live_bytes);
+        console_puts("\n");
+    }
+}
+
+void kmain(uint32_t magic, multiboot_info_t* mbi) {
     char input[MAX_INPUT];
     int pos = 0;
     void* p1;
@@ -70,55 +328,96 @@ void kmain(void) {
     
     /* Initialize hardware */
     serial_init();
+    console_init();
+    idt_init();
+
+    /* "console=vga": debug chatter goes to the framebuffer only */
+    if (magic == MULTIBOOT_BOOTLOADER_MAGIC &&
+        (mbi->flags & MULTIBOOT_INFO_CMDLINE) &&
+        cmdline_has((const char*)mbi->cmdline, "console=vga")) {
+        console_set_level("serial", LOG_INFO);
+    }
+
+    /* Boot modules sit right after the kernel: keep the heap clear of
+       them and use the first one as the initrd */
+    multiboot_module_t* initrd_mod = 0;
+    if (magic == MULTIBOOT_BOOTLOADER_MAGIC &&
+        (mbi->flags & MULTIBOOT_INFO_MODS) && mbi->mods_count > 0) {
+        multiboot_module_t* mods = (multiboot_module_t*)mbi->mods_addr;
+        for (uint32_t i = 0; i < mbi->mods_count; i++) {
+            memory_reserve(mods[i].mod_end);
+        }
+        initrd_mod = &mods[0];
+    }
 
     /* Initialize memory manager */
     memory_init();
 
+    /* Page frames cover the rest of RAM above the heap */
+    uint32_t mem_end = 16 * 1024 * 1024;
+    if (magic == MULTIBOOT_BOOTLOADER_MAGIC &&
+        (mbi->flags & MULTIBOOT_INFO_MEMORY)) {
+        mem_end = (mbi->mem_upper + 1024) * 1024;
+    }
+    paging_init(mem_end);
+    console_puts("Paging: "); console_putint(frame_free_count());
+    console_puts(" free frames\n");
+
+    /* Mount the initrd (read-only, zero-copy) */
+    if (initrd_mod) {
+        int files = initrd_init((const void*)initrd_mod->mod_start,
+                                initrd_mod->mod_end - initrd_mod->mod_start);
+        console_puts("Initrd: "); console_putint(files < 0 ? 0 : files);
+        console_puts(" files\n");
+    } else {
+        console_puts("Initrd: none (boot with -initrd to load one)\n");
+    }
+
     /* ===== Process test (temporary until scheduler arrives) ===== */
     process_init();
 
     int pid = process_create(test_process);
     if (pid >= 0) {
-        serial_puts("Process created successfully\n");
+        console_puts("Process created successfully\n");
     }
 
     /* ===== Extended process tests ===== */
     /* Create multiple processes up to MAX_PROCESSES, check overflow */
-    serial_puts("Creating multiple test processes...\n");
+    console_puts("Creating multiple test processes...\n");
     int created = 0;
     int pids[MAX_PROCESSES];
     for (int i = 0; i < MAX_PROCESSES; i++) {
         int r = process_create(test_process);
         if (r >= 0) {
-            serial_puts(" created pid="); serial_putint(r); serial_puts("\n");
+            console_puts(" created pid="); console_putint(r); console_puts("\n");
             pids[created++] = r;
         } else {
-            serial_puts(" failed to create (process table full)\n");
+            console_puts(" failed to create (process table full)\n");
         }
     }
 
     /* attempt one more - should fail */
     int extra = process_create(test_process);
     if (extra < 0) {
-        serial_puts("Expected failure when creating extra process.\n");
+        console_puts("Expected failure when creating extra process.\n");
     } else {
-        serial_puts("Unexpectedly created extra pid="); serial_putint(extra); serial_puts("\n");
+        console_puts("Unexpectedly created extra pid="); console_putint(extra); console_puts("\n");
     }
 
     /* Run all ready processes sequentially (temporary scheduler) */
-    serial_puts("Running ready processes (manual runner)...\n");
+    console_puts("Running ready processes (manual runner)...\n");
     process_t* p;
     while ((p = get_ready_process()) != 0) {
-        serial_puts(" Running pid="); serial_putint(p->pid); serial_puts("\n");
+        console_puts(" Running pid="); console_putint(p->pid); console_puts("\n");
         process_set_state(p->pid, PROC_CURRENT);
         p->entry();
         process_terminate(p->pid);
     }
-    serial_puts("Finished running ready processes (manual)\n");
+    console_puts("Finished running ready processes (manual)\n");
 
     /* ===== Scheduler tests (Round Robin + Aging) ===== */
     /* Re-create processes to test scheduler if none exist */
-    serial_puts("Re-creating processes for scheduler test...\n");
+    console_puts("Re-creating processes for scheduler test...\n");
     int sched_pids[MAX_PROCESSES];
     int sched_count = 0;
     for (int i = 0; i < MAX_PROCESSES; i++) {
@@ -135,51 +434,52 @@ void kmain(void) {
     }
 
     scheduler_init(1); /* quantum=1 */
-    serial_puts("Running scheduler (schedule())...\n");
+    console_puts("Running scheduler (schedule())...\n");
     while (get_ready_process() != 0) {
         schedule();
     }
-    serial_puts("Scheduler run complete\n");
+    console_puts("Scheduler run complete\n");
     /* ===== End scheduler tests ===== */
     /* ===== End extended tests ===== */
 
     /* ===== Process state-transition tests ===== */
-    serial_puts("Testing process state transitions...\n");
+    console_puts("Testing process state transitions...\n");
     int s_pid = process_create(test_process);
     if (s_pid < 0) {
-        serial_puts("Failed to create process for state-test\n");
+        console_puts("Failed to create process for state-test\n");
     } else {
-        serial_puts(" created pid="); serial_putint(s_pid); serial_puts("\n");
+        console_puts(" created pid="); console_putint(s_pid); console_puts("\n");
 
         process_set_state(s_pid, PROC_NEW);
-        serial_puts(" State -> NEW\n");
+        console_puts(" State -> NEW\n");
 
         process_set_state(s_pid, PROC_WAITING);
-        serial_puts(" State -> WAITING\n");
+        console_puts(" State -> WAITING\n");
 
         process_set_state(s_pid, PROC_READY);
-        serial_puts(" State -> READY\n");
+        console_puts(" State -> READY\n");
 
         process_t* sp = get_process_by_pid(s_pid);
         if (sp) {
-            serial_puts(" get_process_by_pid OK pid="); serial_putint(sp->pid); serial_puts("\n");
+            console_puts(" get_process_by_pid OK pid="); console_putint(sp->pid); console_puts("\n");
         } else {
-            serial_puts(" get_process_by_pid returned NULL\n");
+            console_puts(" get_process_by_pid returned NULL\n");
         }
 
         process_terminate(s_pid);
         sp = get_process_by_pid(s_pid);
-        if (!sp) serial_puts(" Process terminated successfully\n");
-        else serial_puts(" Process still present after terminate\n");
+        if (!sp) console_puts(" Process terminated successfully\n");
+        else console_puts(" Process still present after terminate\n");
     }
     /* ===== End state-transition tests ===== */
 
         /* ===== IPC tests ===== */
         ipc_init();
-        int recv_pid = process_create(receiver_process);
         int send_pid = process_create(sender_process);
+        int recv_pid = process_create(receiver_process);
+        ipc_recv_pid = recv_pid;
         if (recv_pid >= 0 && send_pid >= 0) {
-            serial_puts("IPC processes created (recv="); serial_putint(recv_pid); serial_puts(", send="); serial_putint(send_pid); serial_puts(")\n");
+            console_puts("IPC processes created (recv="); console_putint(recv_pid); console_puts(", send="); console_putint(send_pid); console_puts(")\n");
         }
 
         /* temporary sequential execution for IPC */
@@ -189,42 +489,231 @@ void kmain(void) {
             ipc_p->entry();
             process_terminate(ipc_p->pid);
         }
-        serial_puts("IPC tests complete\n");
+        console_puts("IPC tests complete\n");
         /* ===== End IPC tests ===== */
 
+    /* ===== IPC call/reply tests ===== */
+    console_puts("Testing IPC call/reply...\n");
+    call_server_pid = process_create(call_server);
+    schedule(); /* server runs until it parks in ipc_reply_wait */
+    if (process_create(call_client) >= 0) {
+        schedule();
+    }
+    process_terminate(call_server_pid);
+
+    call_server_pid = process_create(call_sink);
+    process_create(call_orphan);
+    while (get_ready_process() != 0) schedule();   /* both sleep */
+    process_terminate(call_server_pid);
+    while (get_ready_process() != 0) schedule();
+    console_puts("IPC call/reply tests complete\n");
+    /* ===== End IPC call/reply tests ===== */
+
+    /* ===== IPC port tests ===== */
+    console_puts("Testing IPC ports (shared work queue)...\n");
+    work_port = ipc_port_create("work", 16);
+    if (ipc_port_create("work", 16) < 0) console_puts(" Duplicate port name rejected\n");
+    if (ipc_port_lookup("work") == work_port) console_puts(" Port lookup OK\n");
+
+    for (int i = 0; i < 3; i++) process_create(port_worker);
+    while (get_ready_process() != 0) schedule(); /* workers park on the empty port */
+
+    for (int i = 0; i < 6; i++) ipc_port_send(work_port, i);
+    for (int i = 0; i < 3; i++) ipc_port_send(work_port, -1);
+    while (get_ready_process() != 0) schedule();
+    ipc_port_destroy(work_port);
+
+    select_ports[0] = ipc_port_create("sel-a", 4);
+    select_ports[1] = ipc_port_create("sel-b", 4);
+    process_create(select_process);
+    schedule(); /* parks in ipc_wait_any */
+    ipc_port_send(select_ports[1], 42);
+    while (get_ready_process() != 0) schedule();
+    ipc_port_destroy(select_ports[0]);
+    ipc_port_destroy(select_ports[1]);
+    console_puts("IPC port tests complete\n");
+    /* ===== End IPC port tests ===== */
+
+    /* ===== Deferred work tests ===== */
+    /* The worker lives for the rest of the run, so start it only after
+       the manual runners above (they would call its entry directly) */
+    console_puts("Testing deferred work...\n");
+    softirq_init();
+    while (get_ready_process() != 0) schedule(); /* worker parks */
+
+    for (int i = 1; i <= 40; i++) {
+        softirq_raise(softirq_test_work, i); /* as an interrupt handler would */
+    }
+    while (get_ready_process() != 0) schedule();
+
+    if (softirq_sum == 820) console_puts(" Deferred work drained by worker\n");
+    else console_puts(" Deferred work missing items\n");
+    softirq_print_stats();
+    console_puts("Deferred work tests complete\n");
+    /* ===== End deferred work tests ===== */
+
+    /* ===== ELF loader tests ===== */
+    /* Two copies of the same program: text is loaded once and shared,
+       each gets its own data page */
+    if (initrd_lookup("hello.elf")) {
+        console_puts("Testing ELF loader...\n");
+        uint32_t frames = frame_free_count();
+        int e1 = elf_spawn("hello.elf", 0);
+        int e2 = elf_spawn("hello.elf", 0);
+        if (e1 >= 0 && e2 >= 0) console_puts(" Spawned hello.elf twice\n");
+        while (get_ready_process() != 0) schedule();
+
+        elf_stats_t es;
+        elf_get_stats(&es);
+        console_puts(" pages_loaded="); console_putint(es.pages_loaded);
+        console_puts(" pages_shared="); console_putint(es.pages_shared);
+        console_puts("\n");
+        if (es.pages_shared > 0) console_puts(" Text pages shared\n");
+        if (frame_free_count() == frames) console_puts(" All frames returned\n");
+        else console_puts(" Frames leaked\n");
+        console_puts("ELF loader tests complete\n");
+    }
+    /* ===== End ELF loader tests ===== */
+
+    /* ===== Shared memory + futex tests ===== */
+    console_puts("Testing shared memory + futex...\n");
+    shm_test_id = shm_create("test", sizeof(shm_test_t));
+    if (shm_test_id >= 0) {
+        process_create(shm_waiter);     /* runs first and sleeps */
+        process_create(shm_signaller);
+        while (get_ready_process() != 0) schedule();
+
+        if (shm_test_seen == 42) console_puts(" Waiter woken with shared flag\n");
+        else console_puts(" Waiter did not see the flag\n");
+        if (shm_destroy(shm_test_id) == 0) console_puts(" Region detached and destroyed\n");
+
+        process_create(null_test_holder);
+        schedule();                     /* takes the lock and yields */
+        if (mutex_lock(&null_test_lock) == 0) {
+            console_puts(" Null process ran the holder of a contended lock\n");
+            if (mutex_lock(&null_test_lock) < 0)
+                console_puts(" Null process refused a lock nobody can release\n");
+            mutex_unlock(&null_test_lock);
+        }
+
+        shm_test_id = shm_create("test", sizeof(int));
+        process_create(null_test_sleeper);
+        schedule();                     /* attaches and sleeps */
+        uint32_t word = SHM_BASE + (uint32_t)shm_test_id * SHM_MAX_PAGES * PAGE_SIZE;
+        *(volatile int*)shm_translate(word) = 1;
+        futex_wake((volatile int*)word, 1);
+        while (get_ready_process() != 0) schedule();
+        if (null_test_woken) console_puts(" Null process woke a shared-memory sleeper\n");
+        shm_destroy(shm_test_id);
+    } else {
+        console_puts(" shm_create failed\n");
+    }
+    console_puts("Shared memory + futex tests complete\n");
+    /* ===== End shared memory + futex tests ===== */
+
+    /* ===== Task runtime tests ===== */
+    console_puts("Testing task runtime...\n");
+    task_parallel_for(0, 64, 4, task_square, 0);
+    int squares_ok = 1;
+    for (int i = 0; i < 64; i++) {
+        if (task_squares[i] != i * i) squares_ok = 0;
+    }
+    if (squares_ok) console_puts(" parallel_for filled 64 squares\n");
+    else console_puts(" parallel_for missed iterations\n");
+
+    task_fib_t tf = { 15, 0 };
+    task_run(task_fib, &tf);
+    if (tf.result == 610) console_puts(" fib(15) via spawn/join = 610\n");
+    else console_puts(" fib(15) via spawn/join wrong\n");
+
+    while (get_ready_process() != 0) schedule(); /* workers park */
+
+    task_stats_t ts;
+    task_get_stats(&ts);
+    console_puts(" tasks="); console_putint(ts.spawned);
+    console_puts(" executed="); console_putint(ts.executed);
+    console_puts(" steals="); console_putint(ts.steals);
+    console_puts(" inline="); console_putint(ts.inlined);
+    console_puts("\n");
+    console_puts("Task runtime tests complete\n");
+    /* ===== End task runtime tests ===== */
+
     /* ===== Memory Manager Tests ===== */
-    serial_puts("Running memory + stack tests...\n");
+    console_puts("Running memory + stack tests...\n");
 
     /* Simple allocation/deallocation */
     p1 = kmalloc(64);
     p2 = kmalloc(128);
-    if (p1 && p2) serial_puts(" Memory allocation successful\n");
+    if (p1 && p2) console_puts(" Memory allocation successful\n");
     kfree(p1);
     kfree(p2);
-    serial_puts(" Basic memory deallocation successful\n");
+    console_puts(" Basic memory deallocation successful\n");
 
     /* Coalescing test: allocate three small blocks, free middle and left, then allocate larger block */
     void* a1 = kmalloc(64);
     void* a2 = kmalloc(64);
     void* a3 = kmalloc(64);
     if (a1 && a2 && a3) {
-        serial_puts(" Allocated 3 small blocks\n");
+        console_puts(" Allocated 3 small blocks\n");
         kfree(a2);
-        serial_puts(" Freed middle block\n");
+        console_puts(" Freed middle block\n");
         kfree(a1);
-        serial_puts(" Freed left block (should coalesce with middle)\n");
+        console_puts(" Freed left block (should coalesce with middle)\n");
 
         void* big = kmalloc(128);
         if (big) {
-            serial_puts(" Coalescing appears to work (large alloc succeeded)\n");
+            console_puts(" Coalescing appears to work (large alloc succeeded)\n");
             kfree(big);
         } else {
-            serial_puts(" Coalescing failed (large alloc did not succeed)\n");
+            console_puts(" Coalescing failed (large alloc did not succeed)\n");
         }
 
         kfree(a3);
     } else {
-        serial_puts(" Failed to allocate blocks for coalesce test\n");
+        console_puts(" Failed to allocate blocks for coalesce test\n");
+    }
+
+    /* Heap instrumentation: free-list metrics always; in HEAP_DEBUG
+       builds a deliberate overrun and double free must be caught */
+    heap_stats_t hs;
+    heap_get_stats(&hs);
+    console_puts(" Heap free blocks: "); console_putint(hs.free_blocks);
+    console_puts(", largest free: "); console_putint(hs.largest_free);
+    console_puts("\n");
+    if (!kmalloc(0xFFFFFFFF))
+        console_puts(" Oversized kmalloc rejected\n");
+    if (hs.instrumented) {
+        uint32_t errors = hs.errors;
+        char* bad = (char*)kmalloc(10);
+        bad[10] = 'x';      /* one past the end: hits the canary */
+        kfree(bad);
+        kfree(bad);
+        heap_get_stats(&hs);
+        if (hs.errors == errors + 2) console_puts(" Heap canaries caught overrun + double free\n");
+        else console_puts(" Heap canaries missed an error\n");
+    }
+
+    /* Arena test: process-local memory is released in bulk on terminate */
+    uint32_t chunks_before = arena_free_chunks();
+    heap_stats_t arena_hs;
+    heap_get_stats(&arena_hs);
+    uint32_t heap_before = arena_hs.free_bytes;
+    int apid = process_create(arena_process);
+    process_t* ap = get_process_by_pid(apid);
+    if (ap) {
+        process_set_state(apid, PROC_CURRENT);
+        ap->entry();
+        console_puts(" Arena chunks in use: ");
+        console_putint(chunks_before - arena_free_chunks());
+        console_puts("\n");
+        process_terminate(apid);
+        if (arena_free_chunks() == chunks_before)
+            console_puts(" Arena chunks released on terminate\n");
+        else
+            console_puts(" Arena chunks leaked after terminate\n");
+        heap_get_stats(&arena_hs);
+        if (arena_hs.free_bytes == heap_before)
+            console_puts(" Oversized arena block returned to the heap\n");
     }
 
     /* Stack exhaustion test: allocate stacks until failure */
@@ -234,41 +723,46 @@ void kmain(void) {
     while (sc < 32 && (s = alloc_stack()) != 0) {
         stacks[sc++] = s;
     }
-    serial_puts(" Allocated stacks: "); serial_putint(sc); serial_puts("\n");
+    console_puts(" Allocated stacks: "); console_putint(sc); console_puts("\n");
 
     for (int i = 0; i < sc; i++) free_stack(stacks[i]);
-    serial_puts(" Stack free/reuse test done\n");
+    console_puts(" Stack free/reuse test done\n");
 
     /* Scheduler quantum test: create a process that prints and run scheduler with quantum=2 */
-    serial_puts("Scheduler quantum test:\n");
+    console_puts("Scheduler quantum test:\n");
     process_t* qp = 0;
     int qpid = process_create(quantum_process);
     if (qpid >= 0) {
-        serial_puts(" Created quantum-test process pid="); serial_putint(qpid); serial_puts("\n");
+        console_puts(" Created quantum-test process pid="); console_putint(qpid); console_puts("\n");
         scheduler_init(2); /* run entry twice per schedule() */
         /* run one schedule iteration */
         schedule();
-        serial_puts(" Scheduler quantum test completed\n");
+        console_puts(" Scheduler quantum test completed\n");
     } else {
-        serial_puts(" Failed to create quantum-test process\n");
+        console_puts(" Failed to create quantum-test process\n");
     }
 
-    serial_puts("Memory + stack tests complete\n");
+    console_puts("Memory + stack tests complete\n");
     /* ===== End Memory/Stack Tests ===== */
 
 
     
     /* Print welcome message */
-    serial_puts("\n");
-    serial_puts("========================================\n");
-    serial_puts("    kacchiOS - Minimal Baremetal OS\n");
-    serial_puts("========================================\n");
-    serial_puts("Hello from kacchiOS!\n");
-    serial_puts("Running null process...\n\n");
+    console_puts("\n");
+    console_puts("========================================\n");
+    console_puts("    kacchiOS - Minimal Baremetal OS\n");
+    console_puts("========================================\n");
+    console_puts("Hello from kacchiOS!\n");
+    console_puts("Running null process...\n\n");
     
     /* Main loop - the "null process" */
     while (1) {
-        serial_puts("kacchiOS> ");
+        /* Let pending work (e.g. the softirq worker) run first */
+        while (get_ready_process() != 0) {
+            schedule();
+        }
+
+        console_puts("kacchiOS> ");
         pos = 0;
         
         /* Read input line */
@@ -278,26 +772,59 @@ void kmain(void) {
             /* Handle Enter key */
             if (c == '\r' || c == '\n') {
                 input[pos] = '\0';
-                serial_puts("\n");
+                console_puts("\n");
                 break;
             }
             /* Handle Backspace */
             else if ((c == '\b' || c == 0x7F) && pos > 0) {
                 pos--;
-                serial_puts("\b \b");  /* Erase character on screen */
+                console_puts("\b \b");  /* Erase character on screen */
             }
             /* Handle normal characters */
             else if (c >= 32 && c < 127 && pos < MAX_INPUT - 1) {
                 input[pos++] = c;
-                serial_putc(c);  /* Echo character */
+                console_putc(c);  /* Echo character */
             }
         }
         
-        /* Echo back the input */
-        if (pos > 0) {
-            serial_puts("You typed: ");
-            serial_puts(input);
-            serial_puts("\n");
+        /* Built-in commands, otherwise echo back the input */
+        if (pos == 0) {
+            continue;
+        } else if (strcmp(input, "help") == 0) {
+            console_puts("Commands: help, ls, cat <file>, exec <file>, meminfo, softirq,\n"
+                         "          bench ipc, bench console, bench vfs, bench sync,\n"
+                         "          bench heap, bench spawn, bench tasks\n");
+        } else if (strcmp(input, "ls") == 0) {
+            shell_ls();
+        } else if (strncmp(input, "cat ", 4) == 0) {
+            shell_cat(input + 4);
+        } else if (strncmp(input, "exec ", 5) == 0) {
+            if (elf_spawn(input + 5, 0) < 0) {
+                console_puts("exec: cannot run "); console_puts(input + 5);
+                console_puts("\n");
+            }
+        } else if (strcmp(input, "meminfo") == 0) {
+            shell_meminfo();
+        } else if (strcmp(input, "softirq") == 0) {
+            softirq_print_stats();
+        } else if (strcmp(input, "bench ipc") == 0) {
+            bench_ipc();
+        } else if (strcmp(input, "bench console") == 0) {
+            bench_console();
+        } else if (strcmp(input, "bench vfs") == 0) {
+            bench_vfs();
+        } else if (strcmp(input, "bench sync") == 0) {
+            bench_sync();
+        } else if (strcmp(input, "bench tasks") == 0) {
+            bench_tasks();
+        } else if (strcmp(input, "bench heap") == 0) {
+            bench_heap();
+        } else if (strcmp(input, "bench spawn") == 0) {
+            bench_spawn();
+        } else {
+            console_puts("You typed: ");
+            console_puts(input);
+            console_puts("\n");
         }
     }
     
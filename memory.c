@@ -1,4 +1,7 @@
 #include "memory.h"
+#include "process.h"
+#include "console.h"
+#include "string.h"
 
 /* =======================
    CONFIGURATION
@@ -9,11 +12,28 @@
 /* The linker defines `__kernel_end` at the end of the kernel image.
     Place the heap immediately after the kernel to avoid overlapping kernel sections. */
 extern uint32_t __kernel_end;
-#define HEAP_START ((uint32_t)&__kernel_end)
+
+/* Boot modules are loaded right after the kernel; memory_reserve()
+   moves the heap past them. */
+static uint32_t heap_start = (uint32_t)&__kernel_end;
 
 #define STACK_SIZE 4096         // 4 KB per stack
 #define MAX_STACKS 16           // max processes
 
+#define ARENA_CHUNK_SIZE 4096   // 4 KB per arena chunk
+#define MAX_ARENA_CHUNKS 32     // shared by all processes
+#define ARENA_CHUNK_DATA (ARENA_CHUNK_SIZE - sizeof(arena_chunk_t))
+
+/* Instrumentation (make HEAP_DEBUG=1): header magic + tail canary,
+   per-call-site counters. Compiled out entirely otherwise. */
+#ifdef HEAP_DEBUG
+#define HEAP_MAGIC_USED  0xA110CA7E
+#define HEAP_MAGIC_FREE  0xF4EEB10C
+#define HEAP_CANARY      0xC5
+#define HEAP_CANARY_SIZE 4
+#define MAX_HEAP_SITES   16
+#endif
+
 /* =======================
    HEAP STRUCTURE
    ======================= */
@@ -22,10 +42,21 @@ typedef struct block {
     uint32_t size;               // usable size
     uint8_t  free;               // 1 = free, 0 = used
     struct block* next;
+#ifdef HEAP_DEBUG
+    uint32_t magic;              // HEAP_MAGIC_USED / HEAP_MAGIC_FREE
+    void*    site;               // caller of kmalloc
+    uint32_t req;                // requested bytes (canary follows them)
+#endif
 } block_t;
 
 static block_t* free_list;
 
+#ifdef HEAP_DEBUG
+static heap_site_t heap_sites[MAX_HEAP_SITES];
+static uint32_t heap_live, heap_peak;
+static uint32_t heap_allocs, heap_frees, heap_failed, heap_errors;
+#endif
+
 /* =======================
    STACK STRUCTURE
    ======================= */
@@ -33,30 +64,137 @@ static block_t* free_list;
 static uint8_t stack_pool[MAX_STACKS][STACK_SIZE];
 static uint8_t stack_used[MAX_STACKS];
 
+/* =======================
+   ARENA STRUCTURE
+   Chunks live outside the heap so arena traffic never
+   touches the first-fit free list; only allocations too big
+   for a chunk do.
+   ======================= */
+
+static uint8_t arena_pool[MAX_ARENA_CHUNKS][ARENA_CHUNK_SIZE]
+    __attribute__((aligned(16)));
+static arena_chunk_t* arena_free_list;
+static uint32_t arena_free_count;
+
 /* =======================
    MEMORY INIT
    ======================= */
 
+uint32_t memory_heap_end(void) {
+    return heap_start + HEAP_SIZE;
+}
+
+void memory_reserve(uint32_t end) {
+    end = (end + 0xFFF) & ~0xFFF;
+    if (end > heap_start)
+        heap_start = end;
+}
+
 void memory_init(void) {
     /* Initialize heap as one big free block */
-    free_list = (block_t*)HEAP_START;
+    free_list = (block_t*)heap_start;
     free_list->size = HEAP_SIZE - sizeof(block_t);
     free_list->free = 1;
     free_list->next = 0;
+#ifdef HEAP_DEBUG
+    free_list->magic = HEAP_MAGIC_FREE;
+#endif
 
     /* Initialize stack usage table */
     for (int i = 0; i < MAX_STACKS; i++)
         stack_used[i] = 0;
+
+    /* Thread every arena chunk onto the free chunk list */
+    arena_free_list = 0;
+    for (int i = MAX_ARENA_CHUNKS - 1; i >= 0; i--) {
+        arena_chunk_t* chunk = (arena_chunk_t*)arena_pool[i];
+        chunk->next = arena_free_list;
+        chunk->used = 0;
+        arena_free_list = chunk;
+    }
+    arena_free_count = MAX_ARENA_CHUNKS;
 }
 
+#ifdef HEAP_DEBUG
+/* =======================
+   HEAP INSTRUMENTATION
+   ======================= */
+
+/* Counters for one call site; once the table is full, new sites
+   share the last slot (reported with site == 0) */
+static heap_site_t* heap_site(void* site) {
+    heap_site_t* other = &heap_sites[MAX_HEAP_SITES - 1];
+    for (int i = 0; i < MAX_HEAP_SITES - 1; i++) {
+        if (heap_sites[i].site == site)
+            return &heap_sites[i];
+        if (!heap_sites[i].site) {
+            heap_sites[i].site = site;
+            return &heap_sites[i];
+        }
+    }
+    return other;
+}
+
+static void heap_report(const char* what, void* ptr, void* caller, block_t* block) {
+    heap_errors++;
+    console_log(LOG_ERROR, "heap: ");
+    console_log(LOG_ERROR, what);
+    console_log(LOG_ERROR, " ptr=");
+    console_log_hex(LOG_ERROR, (uint32_t)ptr);
+    console_log(LOG_ERROR, " caller=");
+    console_log_hex(LOG_ERROR, (uint32_t)caller);
+    if (block) {
+        console_log(LOG_ERROR, " allocated at ");
+        console_log_hex(LOG_ERROR, (uint32_t)block->site);
+    }
+    console_log(LOG_ERROR, "\n");
+}
+
+/* Validate a block handed to kfree; 0 means do not free it */
+static int heap_check(block_t* block, void* caller) {
+    void* ptr = block + 1;
+
+    if (block->magic == HEAP_MAGIC_FREE) {
+        heap_report("double kfree", ptr, caller, block);
+        return 0;
+    }
+    if (block->magic != HEAP_MAGIC_USED) {
+        heap_report("bad pointer or corrupt header", ptr, caller, 0);
+        return 0;
+    }
+
+    uint8_t* tail = (uint8_t*)ptr + block->req;
+    for (int i = 0; i < HEAP_CANARY_SIZE; i++) {
+        if (tail[i] != HEAP_CANARY) {
+            heap_report("overrun", ptr, caller, block);
+            break;  // still free it: the header is intact
+        }
+    }
+    return 1;
+}
+#endif
+
 /* =======================
    HEAP ALLOCATION
    Optimized First-Fit
    ======================= */
 
 void* kmalloc(uint32_t size) {
+    /* Nothing bigger than the heap fits, and rounding such a size up
+       (plus the canary) could wrap around to a small one */
+    if (size > HEAP_SIZE) {
+#ifdef HEAP_DEBUG
+        heap_failed++;
+#endif
+        return 0;
+    }
+
     /* Align size to 4 bytes for safety */
+#ifdef HEAP_DEBUG
+    uint32_t asize = (size + HEAP_CANARY_SIZE + 3) & ~3;
+#else
     uint32_t asize = (size + 3) & ~3;
+#endif
 
     block_t* curr = free_list;
     block_t* prev = 0;
@@ -73,12 +211,31 @@ void* kmalloc(uint32_t size) {
                 new_block->size = curr->size - asize - sizeof(block_t);
                 new_block->free = 1;
                 new_block->next = curr->next;
+#ifdef HEAP_DEBUG
+                new_block->magic = HEAP_MAGIC_FREE;
+#endif
 
                 curr->next = new_block;
                 curr->size = asize;
             }
 
             curr->free = 0;
+#ifdef HEAP_DEBUG
+            curr->magic = HEAP_MAGIC_USED;
+            curr->site = __builtin_return_address(0);
+            curr->req = size;
+            for (int i = 0; i < HEAP_CANARY_SIZE; i++)
+                ((uint8_t*)(curr + 1))[size + i] = HEAP_CANARY;
+
+            heap_site_t* s = heap_site(curr->site);
+            s->allocs++;
+            s->bytes += size;
+            s->live_bytes += size;
+            heap_allocs++;
+            heap_live += size;
+            if (heap_live > heap_peak)
+                heap_peak = heap_live;
+#endif
             return (void*)(curr + 1); // usable memory
         }
 
@@ -86,6 +243,9 @@ void* kmalloc(uint32_t size) {
         curr = curr->next;
     }
 
+#ifdef HEAP_DEBUG
+    heap_failed++;
+#endif
     return 0; // allocation failed
 }
 
@@ -97,6 +257,17 @@ void kfree(void* ptr) {
     if (!ptr) return;
 
     block_t* block = ((block_t*)ptr) - 1;
+#ifdef HEAP_DEBUG
+    if (!heap_check(block, __builtin_return_address(0)))
+        return;
+
+    heap_site_t* s = heap_site(block->site);
+    s->frees++;
+    s->live_bytes -= block->req;
+    heap_frees++;
+    heap_live -= block->req;
+    block->magic = HEAP_MAGIC_FREE;
+#endif
     block->free = 1;
 
     /* Coalesce with next block if it's free */
@@ -119,6 +290,171 @@ void kfree(void* ptr) {
     }
 }
 
+/* =======================
+   HEAP STATISTICS
+   The free-list walk is on demand only; the live/peak and
+   per-site counters exist only in HEAP_DEBUG builds.
+   ======================= */
+
+static int heap_bucket(uint32_t size) {
+    int b = 0;
+    uint32_t limit = HEAP_HIST_MIN;
+    while (size >= limit && b < HEAP_HIST_BUCKETS - 1) {
+        limit <<= 2;
+        b++;
+    }
+    return b;
+}
+
+void heap_get_stats(heap_stats_t* st) {
+    memset(st, 0, sizeof(*st));
+    st->heap_size = HEAP_SIZE;
+
+    for (block_t* b = free_list; b; b = b->next) {
+        if (!b->free) {
+            st->used_blocks++;
+            continue;
+        }
+        st->free_blocks++;
+        st->free_bytes += b->size;
+        if (b->size > st->largest_free)
+            st->largest_free = b->size;
+
+        int i = heap_bucket(b->size);
+        st->hist_blocks[i]++;
+        st->hist_bytes[i] += b->size;
+    }
+
+#ifdef HEAP_DEBUG
+    st->instrumented = 1;
+    st->live_bytes = heap_live;
+    st->peak_bytes = heap_peak;
+    st->allocs = heap_allocs;
+    st->frees = heap_frees;
+    st->failed = heap_failed;
+    st->errors = heap_errors;
+#endif
+}
+
+int heap_get_sites(heap_site_t* out, int max) {
+#ifdef HEAP_DEBUG
+    int n = 0;
+    for (int i = 0; i < MAX_HEAP_SITES && n < max; i++) {
+        if (heap_sites[i].allocs)
+            out[n++] = heap_sites[i];
+    }
+    return n;
+#else
+    (void)out;
+    (void)max;
+    return 0;
+#endif
+}
+
+/* =======================
+   ARENA ALLOCATION
+   Pointer bump in the head chunk
+   ======================= */
+
+static int arena_in_pool(arena_chunk_t* chunk) {
+    return (uint8_t*)chunk >= arena_pool[0] &&
+           (uint8_t*)chunk < arena_pool[MAX_ARENA_CHUNKS];
+}
+
+void* arena_alloc(arena_chunk_t** chain, uint32_t size) {
+    if (size == 0)
+        return 0;
+
+    arena_chunk_t* head = *chain;
+
+    /* Too big for a chunk: a heap block of its own, linked in behind
+       the head so the head keeps bumping */
+    if (size > ARENA_CHUNK_DATA) {
+        if (size > HEAP_SIZE)
+            return 0;
+        arena_chunk_t* big = (arena_chunk_t*)kmalloc(sizeof(arena_chunk_t) + size);
+        if (!big)
+            return 0;
+
+        big->used = (size + 3) & ~3;
+        if (head) {
+            big->next = head->next;
+            head->next = big;
+        } else {
+            big->next = 0;
+            *chain = big;
+        }
+        return big + 1;
+    }
+
+    uint32_t asize = (size + 3) & ~3;
+
+    /* Head chunk full: take a fresh chunk from the pool */
+    if (!head || head->used + asize > ARENA_CHUNK_DATA) {
+        if (!arena_free_list)
+            return 0; // pool exhausted
+
+        head = arena_free_list;
+        arena_free_list = head->next;
+        arena_free_count--;
+
+        head->used = 0;
+        head->next = *chain;
+        *chain = head;
+    }
+
+    void* ptr = (uint8_t*)(head + 1) + head->used;
+    head->used += asize;
+    return ptr;
+}
+
+/* =======================
+   ARENA RELEASE
+   Returns the whole chain to the pool, O(chunks);
+   oversized blocks go back to the heap
+   ======================= */
+
+uint32_t arena_release(arena_chunk_t** chain) {
+    uint32_t released = 0;
+    arena_chunk_t* chunk = *chain;
+
+    while (chunk) {
+        arena_chunk_t* next = chunk->next;
+        if (arena_in_pool(chunk)) {
+            chunk->next = arena_free_list;
+            arena_free_list = chunk;
+            released++;
+        } else {
+            kfree(chunk);
+        }
+        chunk = next;
+    }
+
+    arena_free_count += released;
+    *chain = 0;
+    return released;
+}
+
+uint32_t arena_free_chunks(void) {
+    return arena_free_count;
+}
+
+/* =======================
+   PROCESS-LOCAL ALLOCATION
+   Memory is owned by the current process and released
+   by process_terminate(); never pass it to kfree().
+   ======================= */
+
+void* kmalloc_local(uint32_t size) {
+    process_t* p = get_current_process();
+    if (!p) return 0;
+
+    void* ptr = arena_alloc(&p->arena, size);
+    if (ptr)
+        p->mem_usage += (size + 3) & ~3;
+    return ptr;
+}
+
 /* =======================
    STACK ALLOCATION
    ======================= */
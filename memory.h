@@ -6,10 +6,67 @@
 /* Initialize memory subsystem */
 void memory_init(void);
 
+/* Keep the heap above `end` (e.g. boot modules); call before memory_init */
+void memory_reserve(uint32_t end);
+
+/* First address past the heap (page frames start here) */
+uint32_t memory_heap_end(void);
+
 /* Heap allocation */
 void* kmalloc(uint32_t size);
 void kfree(void* ptr);
 
+/* Heap statistics (see `meminfo`).
+   The free-block figures and histogram are always available; the
+   allocation counters need a HEAP_DEBUG build (make HEAP_DEBUG=1). */
+#define HEAP_HIST_BUCKETS 6     // free blocks by size: <64, <256, ... >=16K
+#define HEAP_HIST_MIN     64
+
+typedef struct {
+    uint32_t heap_size;
+    uint32_t free_bytes;
+    uint32_t free_blocks;
+    uint32_t used_blocks;
+    uint32_t largest_free;       // largest kmalloc that can succeed
+    uint32_t hist_blocks[HEAP_HIST_BUCKETS];
+    uint32_t hist_bytes[HEAP_HIST_BUCKETS];
+
+    int      instrumented;       // 1 if the fields below are live
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failed;             // kmalloc calls that returned 0
+    uint32_t errors;             // double frees, overruns, bad pointers
+} heap_stats_t;
+
+typedef struct {
+    void*    site;               // return address of the kmalloc call
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t bytes;              // total requested
+    uint32_t live_bytes;
+} heap_site_t;
+
+void heap_get_stats(heap_stats_t* st);
+int heap_get_sites(heap_site_t* out, int max);
+
+/* Per-process arena allocation.
+   A process owns a chain of fixed-size chunks; allocations bump a pointer
+   inside the head chunk and are only released all at once. Requests too
+   big for a chunk get a kmalloc block of their own in the same chain. */
+typedef struct arena_chunk {
+    struct arena_chunk* next;
+    uint32_t used;               // bytes handed out from this chunk
+} arena_chunk_t;
+
+void* arena_alloc(arena_chunk_t** chain, uint32_t size);
+uint32_t arena_release(arena_chunk_t** chain);
+uint32_t arena_free_chunks(void);
+
+/* Allocate from the current process's arena (freed on terminate) */
+void* kmalloc_local(uint32_t size);
+
 /* Stack allocation */
 void* alloc_stack(void);
 void free_stack(void* stack);
@@ -0,0 +1,32 @@
+/* multiboot.h - Multiboot (v1) boot information */
+#ifndef MULTIBOOT_H
+#define MULTIBOOT_H
+
+#include "types.h"
+
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002
+
+/* multiboot_info_t.flags */
+#define MULTIBOOT_INFO_MEMORY      0x00000001
+#define MULTIBOOT_INFO_CMDLINE     0x00000004
+#define MULTIBOOT_INFO_MODS        0x00000008
+
+typedef struct {
+    uint32_t flags;
+    uint32_t mem_lower;
+    uint32_t mem_upper;
+    uint32_t boot_device;
+    uint32_t cmdline;
+    uint32_t mods_count;
+    uint32_t mods_addr;         /* multiboot_module_t[mods_count] */
+} multiboot_info_t;
+
+/* Boot module (e.g. QEMU -initrd), loaded at [mod_start, mod_end) */
+typedef struct {
+    uint32_t mod_start;
+    uint32_t mod_end;
+    uint32_t string;
+    uint32_t reserved;
+} multiboot_module_t;
+
+#endif
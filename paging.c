@@ -0,0 +1,216 @@
+/* paging.c - Page frames and address spaces */
+#include "paging.h"
+#include "cpu.h"
+#include "idt.h"
+#include "memory.h"
+#include "process.h"
+#include "scheduler.h"
+#include "console.h"
+#include "string.h"
+#include "elf.h"
+
+#define PDE_INDEX(v)  ((v) >> 22)
+#define PTE_INDEX(v)  (((v) >> 12) & 0x3FF)
+#define FRAME_MASK    0xFFFFF000
+#define LARGE_PAGE    0x400000
+
+#define CR0_WP        0x00010000    /* honour read-only pages in ring 0 */
+#define CR0_PG        0x80000000
+#define CR4_PSE       0x00000010
+
+static uint32_t* kernel_dir;
+static int paging_enabled;
+
+/* Free frames form a stack threaded through the frames themselves */
+static uint32_t free_frames;
+static uint32_t free_count;
+
+/* =========================
+   Frame allocator
+   ========================= */
+uint32_t frame_alloc(void) {
+    uint32_t frame = free_frames;
+    if (!frame)
+        return 0;
+
+    free_frames = *(uint32_t*)frame;
+    free_count--;
+    return frame;
+}
+
+void frame_free(uint32_t frame) {
+    if (!frame)
+        return;
+
+    *(uint32_t*)frame = free_frames;
+    free_frames = frame;
+    free_count++;
+}
+
+uint32_t frame_free_count(void) {
+    return free_count;
+}
+
+/* =========================
+   Page fault handler
+   ========================= */
+static void page_fault(isr_regs_t* regs) {
+    uint32_t addr = read_cr2();
+    process_t* p = get_current_process();
+
+    /* Not-present fault inside a loaded image: page it in */
+    if (p && p->image && !(regs->error & 1) && elf_fault(p, addr) == 0)
+        return;
+
+    console_log(LOG_ERROR, "Page fault at ");
+    console_log_hex(LOG_ERROR, addr);
+    console_log(LOG_ERROR, " eip=");
+    console_log_hex(LOG_ERROR, regs->eip);
+    console_log(LOG_ERROR, " error=");
+    console_log_hex(LOG_ERROR, regs->error);
+    console_log(LOG_ERROR, "\n");
+
+    if (p) {
+        console_log(LOG_ERROR, "Killing process ");
+        console_log_int(LOG_ERROR, p->pid);
+        console_log(LOG_ERROR, "\n");
+        scheduler_exit();   /* only returns outside schedule() */
+    }
+
+    for (;;) {
+        __asm__ volatile ("cli; hlt");
+    }
+}
+
+/* =========================
+   Initialize paging
+   ========================= */
+void paging_init(uint32_t mem_end) {
+    if (mem_end > USER_BASE)
+        mem_end = USER_BASE;
+
+    /* Everything between the heap and the end of RAM becomes frames */
+    free_frames = 0;
+    free_count = 0;
+    uint32_t frame = (memory_heap_end() + PAGE_SIZE - 1) & FRAME_MASK;
+    for (; frame + PAGE_SIZE <= mem_end; frame += PAGE_SIZE)
+        frame_free(frame);
+
+    /* Kernel directory: identity map with 4 MB pages */
+    kernel_dir = (uint32_t*)frame_alloc();
+    memset(kernel_dir, 0, PAGE_SIZE);
+    for (uint32_t i = 0; i < PDE_INDEX(mem_end + LARGE_PAGE - 1); i++)
+        kernel_dir[i] = (i << 22) | PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE;
+
+    idt_set_handler(EXC_PAGE_FAULT, page_fault);
+
+    write_cr3((uint32_t)kernel_dir);
+    write_cr4(read_cr4() | CR4_PSE);
+    write_cr0(read_cr0() | CR0_PG | CR0_WP);
+    paging_enabled = 1;
+}
+
+/* =========================
+   Address spaces
+   ========================= */
+uint32_t paging_create_dir(void) {
+    uint32_t* dir = (uint32_t*)frame_alloc();
+    if (!dir)
+        return 0;
+
+    /* Share the kernel half, start with an empty user region */
+    memcpy(dir, kernel_dir, PDE_INDEX(USER_BASE) * sizeof(uint32_t));
+    memset(dir + PDE_INDEX(USER_BASE), 0,
+           (1024 - PDE_INDEX(USER_BASE)) * sizeof(uint32_t));
+    return (uint32_t)dir;
+}
+
+void paging_destroy_dir(uint32_t dir) {
+    if (!dir)
+        return;
+
+    if (paging_enabled && read_cr3() == dir)
+        write_cr3((uint32_t)kernel_dir);
+
+    uint32_t* pd = (uint32_t*)dir;
+    for (uint32_t i = PDE_INDEX(USER_BASE); i < PDE_INDEX(USER_END); i++) {
+        if (!(pd[i] & PAGE_PRESENT))
+            continue;
+
+        uint32_t* pt = (uint32_t*)(pd[i] & FRAME_MASK);
+        for (int j = 0; j < 1024; j++) {
+            /* Shared frames belong to the image cache */
+            if ((pt[j] & PAGE_PRESENT) && !(pt[j] & PAGE_SHARED))
+                frame_free(pt[j] & FRAME_MASK);
+        }
+        frame_free((uint32_t)pt);
+    }
+    frame_free(dir);
+}
+
+void paging_activate(uint32_t dir) {
+    if (!paging_enabled)
+        return;
+
+    uint32_t target = dir ? dir : (uint32_t)kernel_dir;
+    if (read_cr3() != target)
+        write_cr3(target);
+}
+
+int paging_map(uint32_t dir, uint32_t vaddr, uint32_t frame, uint32_t flags) {
+    if (!dir || vaddr < USER_BASE || vaddr >= USER_END)
+        return -1;
+
+    uint32_t* pd = (uint32_t*)dir;
+    uint32_t* pde = &pd[PDE_INDEX(vaddr)];
+
+    /* Page tables are writable; the PTE decides the access rights */
+    if (!(*pde & PAGE_PRESENT)) {
+        uint32_t pt = frame_alloc();
+        if (!pt)
+            return -1;
+        memset((void*)pt, 0, PAGE_SIZE);
+        *pde = pt | PAGE_PRESENT | PAGE_WRITE;
+    }
+
+    uint32_t* pt = (uint32_t*)(*pde & FRAME_MASK);
+    pt[PTE_INDEX(vaddr)] = (frame & FRAME_MASK) | flags | PAGE_PRESENT;
+
+    if (paging_enabled && read_cr3() == dir)
+        invlpg(vaddr);
+    return 0;
+}
+
+void paging_unmap(uint32_t dir, uint32_t vaddr) {
+    if (!dir || vaddr < USER_BASE || vaddr >= USER_END)
+        return;
+
+    uint32_t pde = ((uint32_t*)dir)[PDE_INDEX(vaddr)];
+    if (!(pde & PAGE_PRESENT))
+        return;
+
+    /* The frame stays with its owner; only the entry goes */
+    ((uint32_t*)(pde & FRAME_MASK))[PTE_INDEX(vaddr)] = 0;
+    if (paging_enabled && read_cr3() == dir)
+        invlpg(vaddr);
+}
+
+int paging_is_mapped(uint32_t dir, uint32_t vaddr) {
+    return paging_translate(dir, vaddr) != 0;
+}
+
+uint32_t paging_translate(uint32_t dir, uint32_t vaddr) {
+    if (vaddr < USER_BASE)
+        return vaddr;           /* kernel identity map */
+    if (!dir || vaddr >= USER_END)
+        return 0;
+
+    uint32_t pde = ((uint32_t*)dir)[PDE_INDEX(vaddr)];
+    if (!(pde & PAGE_PRESENT))
+        return 0;
+
+    uint32_t pte = ((uint32_t*)(pde & FRAME_MASK))[PTE_INDEX(vaddr)];
+    if (!(pte & PAGE_PRESENT))
+        return 0;
+    return (pte & FRAME_MASK) | (vaddr & (PAGE_SIZE - 1));
+}
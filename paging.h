@@ -0,0 +1,40 @@
+/* paging.h - Page frames and address spaces */
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "types.h"
+
+#define PAGE_SIZE     4096
+
+#define PAGE_PRESENT  0x001
+#define PAGE_WRITE    0x002
+#define PAGE_LARGE    0x080     /* 4 MB page (PSE) */
+#define PAGE_SHARED   0x200     /* available bit: frame not owned by the space */
+
+/* Per-process user region; everything below is the shared kernel
+   identity map */
+#define USER_BASE     0x40000000
+#define USER_END      0x80000000
+#define SHM_BASE      0x70000000    /* top of the user region: shm windows */
+
+/* Identity-map [0, mem_end) with 4 MB pages, set up the frame pool
+   above the heap and turn paging on */
+void paging_init(uint32_t mem_end);
+
+/* Physical page frames (identity-mapped, so usable as pointers) */
+uint32_t frame_alloc(void);
+void frame_free(uint32_t frame);
+uint32_t frame_free_count(void);
+
+/* Address spaces: dir == 0 means the kernel directory */
+uint32_t paging_create_dir(void);
+void paging_destroy_dir(uint32_t dir);
+void paging_activate(uint32_t dir);
+int paging_map(uint32_t dir, uint32_t vaddr, uint32_t frame, uint32_t flags);
+void paging_unmap(uint32_t dir, uint32_t vaddr);
+int paging_is_mapped(uint32_t dir, uint32_t vaddr);
+
+/* Physical address behind vaddr in dir (0 if unmapped) */
+uint32_t paging_translate(uint32_t dir, uint32_t vaddr);
+
+#endif
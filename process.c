@@ -1,8 +1,13 @@
 #include "process.h"
 #include "memory.h"
+#include "paging.h"
+#include "elf.h"
+#include "shm.h"
+#include "futex.h"
+#include "ipc.h"
 
 static process_t process_table[MAX_PROCESSES];
-static int current_pid = -1;
+static process_t* current_proc = 0;
 static int pid_counter = 0;
 
 /* =========================
@@ -14,6 +19,11 @@ void process_init(void) {
         process_table[i].pid = -1;
         process_table[i].entry = 0;
         process_table[i].stack = 0;
+        process_table[i].context = 0;
+        process_table[i].page_dir = 0;
+        process_table[i].image = 0;
+        process_table[i].arena = 0;
+        process_table[i].mem_usage = 0;
     }
 }
 
@@ -21,14 +31,38 @@ void process_init(void) {
    Create a new process
    ========================= */
 int process_create(void (*entry)(void)) {
+    return process_create_on_stack(entry, 0);
+}
+
+/* stack_top == 0: take a STACK_SIZE slot from the pool. Otherwise the
+   caller owns the stack (free_stack() ignores it on terminate). */
+int process_create_on_stack(void (*entry)(void), void* stack_top) {
     for (int i = 0; i < MAX_PROCESSES; i++) {
         if (process_table[i].state == PROC_TERMINATED) {
 
+            void* stack = stack_top ? stack_top : alloc_stack();
+            if (!stack)
+                return -1;  // no stack available
+
             process_table[i].pid = pid_counter++;
             process_table[i].entry = entry;
-            process_table[i].stack = alloc_stack();
+            process_table[i].stack = stack;
+            process_table[i].context = 0;
+            process_table[i].wake_value = 0;
+            process_table[i].page_dir = 0;
+            process_table[i].image = 0;
             process_table[i].priority = 1; // default
             process_table[i].age = 0;
+            process_table[i].arena = 0;
+            process_table[i].mem_usage = 0;
+            process_table[i].ipc_wait = 0;
+            process_table[i].ipc_peer = -1;
+            process_table[i].ipc_msg = 0;
+            process_table[i].ipc_pending = 0;
+            process_table[i].ipc_ports = 0;
+            process_table[i].shm_mask = 0;
+            process_table[i].futex_key = 0;
+            process_table[i].futex_next = 0;
             process_table[i].state = PROC_READY;
 
             return process_table[i].pid;
@@ -41,16 +75,19 @@ int process_create(void (*entry)(void)) {
    Set process state
    ========================= */
 void process_set_state(int pid, proc_state_t state) {
-    process_t* p = get_process_by_pid(pid);
+    process_change_state(get_process_by_pid(pid), state);
+}
+
+/* Same as process_set_state for callers that already hold the PCB */
+void process_change_state(process_t* p, proc_state_t state) {
     if (p) {
         p->state = state;
         if (state == PROC_CURRENT) {
-            current_pid = pid;
-        } else if (state == PROC_TERMINATED) {
-            if (current_pid == pid) current_pid = -1;
-        } else if (current_pid == pid && state != PROC_CURRENT) {
+            current_proc = p;
+            paging_activate(p->page_dir);
+        } else if (current_proc == p) {
             /* leaving current state */
-            current_pid = -1;
+            current_proc = 0;
         }
     }
 }
@@ -64,9 +101,25 @@ void process_terminate(int pid) {
 
     free_stack(p->stack);
     p->stack = 0;
+    p->context = 0;
+    arena_release(&p->arena);
+
+    ipc_cancel(p);
+    futex_cancel(p);
+    shm_detach_all(p);
+
+    /* Drop the address space before the image whose frames it shares */
+    paging_destroy_dir(p->page_dir);
+    p->page_dir = 0;
+    if (p->image) {
+        elf_release(p->image);
+        p->image = 0;
+    }
+
+    p->mem_usage = 0;
     p->state = PROC_TERMINATED;
     p->pid = -1; /* free slot for reuse and ensure get_process_by_pid returns NULL */
-    if (current_pid == pid) current_pid = -1;
+    if (current_proc == p) current_proc = 0;
 }
 
 /* =========================
@@ -83,7 +136,7 @@ process_t* get_process_by_pid(int pid) {
 }
 
 process_t* get_current_process(void) {
-    return get_process_by_pid(current_pid);
+    return current_proc;
 }
 
 process_t* get_ready_process(void) {
@@ -95,6 +148,11 @@ process_t* get_ready_process(void) {
     return 0;
 }
 
+int get_process_index(int pid) {
+    process_t* p = get_process_by_pid(pid);
+    return p ? (int)(p - process_table) : -1;
+}
+
 process_t* get_process_at_index(int index) {
     if (index < 0 || index >= MAX_PROCESSES) return 0;
     return &process_table[index];
@@ -2,9 +2,12 @@
 #define PROCESS_H
 
 #include "types.h"
+#include "memory.h"
 
 /* Maximum number of processes */
-#define MAX_PROCESSES 8
+#define MAX_PROCESSES 16
+
+struct elf_image;
 
 /* Process states */
 typedef enum {
@@ -21,15 +24,35 @@ typedef struct process {
     proc_state_t state;
     void (*entry)(void);   // process function
     void* stack;           // stack pointer
+    uint32_t context;      // saved esp while switched out (0 = not started)
+    int wake_value;        // delivered by the scheduler on resume
+
+    uint32_t page_dir;         // address space (0 = kernel only)
+    struct elf_image* image;   // ELF program backing the user region
 
     int priority;   // base priority
     int age;        // aging counter
+
+    arena_chunk_t* arena;  // process-local heap chunks
+    uint32_t mem_usage;    // bytes allocated via kmalloc_local
+
+    int ipc_wait;   // IPC blocking state (see ipc.c)
+    int ipc_peer;   // call partner pid, -1 if none
+    int ipc_msg;    // message parked on the queued call path
+    int ipc_pending;  // callers queued on this process
+    uint32_t ipc_ports;  // port mask while sleeping in ipc_wait_any
+
+    uint32_t shm_mask;          // attached shared memory regions
+    uint32_t futex_key;         // word slept on (physical address), 0 if none
+    struct process* futex_next; // next waiter in the same futex bucket
 } process_t;
 
 /* Process Manager API */
 void process_init(void);
 int process_create(void (*entry)(void));
+int process_create_on_stack(void (*entry)(void), void* stack_top);
 void process_set_state(int pid, proc_state_t state);
+void process_change_state(process_t* p, proc_state_t state);
 void process_terminate(int pid);
 
 /* Utility functions */
@@ -37,5 +60,6 @@ process_t* get_current_process(void);
 process_t* get_ready_process(void);
 process_t* get_process_by_pid(int pid);
 process_t* get_process_at_index(int index);
+int get_process_index(int pid);
 
 #endif
@@ -1,8 +1,14 @@
 #include "scheduler.h"
 #include "process.h"
-#include "serial.h"
+#include "context.h"
+#include "console.h"
 
 static int time_quantum;
+static int verbose = 1;
+
+/* Saved scheduler stack while a process runs on its own stack */
+static uint32_t sched_context;
+static int sched_active;
 
 /* =========================
    Initialize Scheduler
@@ -11,6 +17,10 @@ void scheduler_init(int quantum) {
     time_quantum = quantum;
 }
 
+void scheduler_set_verbose(int on) {
+    verbose = on;
+}
+
 /* =========================
    Select next process
    Policy: Round Robin + Aging
@@ -35,6 +45,21 @@ static process_t* select_next_process(void) {
     return selected;
 }
 
+/* =========================
+   Process start trampoline
+   First code run on a fresh process stack
+   ========================= */
+static void process_start(void) {
+    process_t* p = get_current_process();
+
+    /* Run process for `time_quantum` quanta (cooperative simulation) */
+    for (int q = 0; q < time_quantum; q++) {
+        p->entry();
+    }
+
+    scheduler_exit();
+}
+
 /* =========================
    Scheduler main function
    ========================= */
@@ -44,22 +69,97 @@ void schedule(void) {
     if (!p)
         return;
 
-    /* Context switch (software-level) */
-    process_set_state(p->pid, PROC_CURRENT);
+    /* Context switch onto the process stack */
+    process_change_state(p, PROC_CURRENT);
 
-    serial_puts("[Scheduler] Running process ");
-    serial_putc('0' + p->pid);
-    serial_puts("\n");
+    if (verbose) {
+        console_log(LOG_DEBUG, "[Scheduler] Running process ");
+        console_log_int(LOG_DEBUG, p->pid);
+        console_log(LOG_DEBUG, "\n");
+    }
 
-    /* Run process for `time_quantum` quanta (cooperative simulation) */
     if (time_quantum <= 0) time_quantum = 1;
-    for (int q = 0; q < time_quantum; q++) {
-        p->entry();
-    }
+    if (!p->context)
+        p->context = context_init(p->stack, process_start);
 
-    /* After execution we consider this run complete and terminate the process.
-       (Note: this simple kernel treats a single function invocation as a run
-       slice and then cleans up; preemption would require hardware/timer.) */
+    sched_active = 1;
+    int exited = context_switch(&sched_context, p->context, p->wake_value);
+    sched_active = 0;
     p->age = 0;
-    process_terminate(p->pid);
+
+    /* A process that blocked comes back with -1 and stays alive.
+       (Note: a finished run slice still terminates the process;
+       preemption would require hardware/timer.) */
+    if (exited >= 0)
+        process_terminate(exited);
+}
+
+/* =========================
+   Block current process
+   ========================= */
+int scheduler_can_block(void) {
+    return sched_active && get_current_process() != 0;
+}
+
+int scheduler_block(int* value) {
+    process_t* p = get_current_process();
+    if (!sched_active || !p)
+        return -1;
+
+    process_change_state(p, PROC_WAITING);
+    int v = context_switch(&p->context, sched_context, -1);
+    if (value) *value = v;
+    return 0;
+}
+
+/* =========================
+   Exit current process
+   Hand our pid back to schedule() so it can free this stack
+   ========================= */
+void scheduler_exit(void) {
+    process_t* p = get_current_process();
+    if (!sched_active || !p)
+        return;
+
+    context_switch(&p->context, sched_context, p->pid);
+}
+
+/* =========================
+   Yield current process
+   ========================= */
+void scheduler_yield(void) {
+    process_t* p = get_current_process();
+    if (!sched_active || !p)
+        return;
+
+    process_change_state(p, PROC_READY);
+    context_switch(&p->context, sched_context, -1);
+}
+
+/* =========================
+   Direct handoff
+   Switch to a blocked process without a scheduler pass
+   ========================= */
+int scheduler_handoff(process_t* to, int msg, int* value) {
+    process_t* p = get_current_process();
+    if (!sched_active || !p || !to || !to->context ||
+        to->state != PROC_WAITING)
+        return -1;
+
+    process_change_state(p, PROC_WAITING);
+    process_change_state(to, PROC_CURRENT);
+    int v = context_switch(&p->context, to->context, msg);
+    if (value) *value = v;
+    return 0;
+}
+
+/* =========================
+   Wake a blocked process
+   ========================= */
+void scheduler_wake(process_t* p, int value) {
+    if (!p || p->state != PROC_WAITING)
+        return;
+
+    p->wake_value = value;
+    process_change_state(p, PROC_READY);
 }
@@ -2,6 +2,7 @@
 #define SCHEDULER_H
 
 #include "types.h"
+#include "process.h"
 
 /* Initialize scheduler with time quantum */
 void scheduler_init(int quantum);
@@ -9,4 +10,24 @@ void scheduler_init(int quantum);
 /* Run scheduler */
 void schedule(void);
 
+/* Enable/disable the per-run "[Scheduler]" log line */
+void scheduler_set_verbose(int on);
+
+/* Blocking primitives (only valid inside a process started by schedule()).
+   Both store the value delivered on resume in *value and return 0,
+   or return -1 if the caller cannot block. */
+int scheduler_can_block(void);
+int scheduler_block(int* value);
+int scheduler_handoff(process_t* to, int msg, int* value);
+
+/* Terminate the current process from anywhere on its stack
+   (returns only when called outside schedule()) */
+void scheduler_exit(void);
+
+/* Give up the CPU but stay READY */
+void scheduler_yield(void);
+
+/* Make a blocked process READY; `value` is returned from its block call */
+void scheduler_wake(process_t* p, int value);
+
 #endif
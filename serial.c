@@ -50,6 +50,26 @@ void serial_puts(const char* str) {
     }
 }
 
+/* Print a non-negative integer */
+void serial_putint(int v) {
+    char buf[12];
+    int i = 0;
+    if (v == 0) {
+        buf[i++] = '0';
+    } else {
+        int n = v;
+        char tmp[12];
+        int ti = 0;
+        while (n > 0 && ti < (int)sizeof(tmp)) {
+            tmp[ti++] = '0' + (n % 10);
+            n /= 10;
+        }
+        while (ti > 0) buf[i++] = tmp[--ti];
+    }
+    buf[i] = '\0';
+    serial_puts(buf);
+}
+
 static int serial_received(void) {
     return inb(COM1 + 5) & 0x01;
 }
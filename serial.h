@@ -7,6 +7,7 @@
 void serial_init(void);
 void serial_putc(char c);
 void serial_puts(const char* str);
+void serial_putint(int v);
 char serial_getc(void);
 
 #endif
\ No newline at end of file
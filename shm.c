@@ -0,0 +1,134 @@
+/* shm.c - Named shared memory regions */
+#include "shm.h"
+#include "paging.h"
+#include "string.h"
+
+typedef struct {
+    char name[SHM_NAME_LEN];
+    uint32_t frames[SHM_MAX_PAGES];
+    uint32_t pages;
+    int refs;               /* attached processes */
+    int used;
+} shm_region_t;
+
+static shm_region_t regions[MAX_SHM_REGIONS];
+
+static uint32_t shm_addr(int id) {
+    return SHM_BASE + (uint32_t)id * SHM_MAX_PAGES * PAGE_SIZE;
+}
+
+static int shm_valid(int id) {
+    return id >= 0 && id < MAX_SHM_REGIONS && regions[id].used;
+}
+
+static void shm_free_frames(shm_region_t* r) {
+    for (uint32_t i = 0; i < r->pages; i++)
+        frame_free(r->frames[i]);
+    r->pages = 0;
+}
+
+int shm_lookup(const char* name) {
+    for (int i = 0; i < MAX_SHM_REGIONS; i++) {
+        if (regions[i].used && strcmp(regions[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int shm_create(const char* name, uint32_t size) {
+    uint32_t pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    if (!name || pages == 0 || pages > SHM_MAX_PAGES || shm_lookup(name) >= 0)
+        return -1;
+
+    for (int i = 0; i < MAX_SHM_REGIONS; i++) {
+        shm_region_t* r = &regions[i];
+        if (r->used)
+            continue;
+
+        /* Backing frames are allocated up front and zeroed */
+        r->pages = 0;
+        while (r->pages < pages) {
+            uint32_t frame = frame_alloc();
+            if (!frame) {
+                shm_free_frames(r);
+                return -1;
+            }
+            memset((void*)frame, 0, PAGE_SIZE);
+            r->frames[r->pages++] = frame;
+        }
+
+        int n = 0;
+        while (name[n] && n < SHM_NAME_LEN - 1) {
+            r->name[n] = name[n];
+            n++;
+        }
+        r->name[n] = '\0';
+
+        r->refs = 0;
+        r->used = 1;
+        return i;
+    }
+    return -1;
+}
+
+void* shm_attach(int id) {
+    process_t* p = get_current_process();
+    if (!p || !shm_valid(id))
+        return 0;
+
+    shm_region_t* r = &regions[id];
+    uint32_t addr = shm_addr(id);
+    if (p->shm_mask & (1u << id))
+        return (void*)addr;
+
+    /* Kernel processes get an address space on first attach */
+    if (!p->page_dir) {
+        p->page_dir = paging_create_dir();
+        if (!p->page_dir)
+            return 0;
+        paging_activate(p->page_dir);
+    }
+
+    /* Frames belong to the region, not the address space */
+    for (uint32_t i = 0; i < r->pages; i++) {
+        if (paging_map(p->page_dir, addr + i * PAGE_SIZE, r->frames[i],
+                       PAGE_WRITE | PAGE_SHARED) < 0) {
+            while (i-- > 0)
+                paging_unmap(p->page_dir, addr + i * PAGE_SIZE);
+            return 0;
+        }
+    }
+
+    p->shm_mask |= 1u << id;
+    r->refs++;
+    return (void*)addr;
+}
+
+uint32_t shm_translate(uint32_t vaddr) {
+    if (vaddr < SHM_BASE)
+        return 0;
+
+    uint32_t page = (vaddr - SHM_BASE) / PAGE_SIZE;
+    int id = page / SHM_MAX_PAGES;
+    if (!shm_valid(id) || page % SHM_MAX_PAGES >= regions[id].pages)
+        return 0;
+    return regions[id].frames[page % SHM_MAX_PAGES] + (vaddr & (PAGE_SIZE - 1));
+}
+
+int shm_destroy(int id) {
+    if (!shm_valid(id) || regions[id].refs > 0)
+        return -1;
+
+    shm_free_frames(&regions[id]);
+    regions[id].used = 0;
+    return 0;
+}
+
+void shm_detach_all(process_t* p) {
+    /* The mappings go away with the page directory */
+    for (int i = 0; i < MAX_SHM_REGIONS; i++) {
+        if (p->shm_mask & (1u << i))
+            regions[i].refs--;
+    }
+    p->shm_mask = 0;
+}
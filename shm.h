@@ -0,0 +1,30 @@
+/* shm.h - Named shared memory regions */
+#ifndef SHM_H
+#define SHM_H
+
+#include "types.h"
+#include "process.h"
+
+#define MAX_SHM_REGIONS  8
+#define SHM_MAX_PAGES    16     /* 64 KB per region */
+#define SHM_NAME_LEN     16
+
+/* Regions are mapped at the same address in every process
+   (SHM_BASE + id * 64 KB), so pointers into them can be shared */
+int shm_create(const char* name, uint32_t size);
+int shm_lookup(const char* name);
+
+/* Map region into the current process; returns its address or 0 */
+void* shm_attach(int id);
+
+/* Physical address behind vaddr if it lies in a live region's window,
+   else 0; the same in every address space, attached or not */
+uint32_t shm_translate(uint32_t vaddr);
+
+/* Fails (-1) while any process is still attached */
+int shm_destroy(int id);
+
+/* Called on process termination */
+void shm_detach_all(process_t* p);
+
+#endif
@@ -0,0 +1,130 @@
+#include "softirq.h"
+#include "cpu.h"
+#include "process.h"
+#include "scheduler.h"
+
+typedef struct {
+    softirq_fn_t fn;
+    uint32_t arg;
+    uint32_t stamp;         /* TSC at raise, for latency */
+} softirq_item_t;
+
+/* Single-producer (this CPU's interrupt handlers) /
+   single-consumer (this CPU's worker) ring. Indices run freely and
+   are masked on access, so head == tail means empty. */
+typedef struct {
+    softirq_item_t items[SOFTIRQ_RING_SIZE];
+    volatile uint32_t head;     /* next item to run (worker) */
+    volatile uint32_t tail;     /* next free slot (producer) */
+    int worker_pid;
+    softirq_stats_t stats;
+} softirq_ring_t;
+
+static softirq_ring_t rings[NR_CPUS];
+
+/* =========================
+   Worker process
+   ========================= */
+static void softirq_drain(softirq_ring_t* ring) {
+    uint32_t head = ring->head;
+    uint32_t tail = ring->tail;
+    uint32_t n = 0;
+
+    while (head != tail && n < SOFTIRQ_BATCH) {
+        softirq_item_t* item = &ring->items[head & (SOFTIRQ_RING_SIZE - 1)];
+
+        uint32_t latency = (uint32_t)rdtsc() - item->stamp;
+        if (latency > ring->stats.max_latency)
+            ring->stats.max_latency = latency;
+        if (ring->stats.drained + n == 0)
+            ring->stats.avg_latency = latency;
+        else
+            ring->stats.avg_latency += ((int32_t)(latency - ring->stats.avg_latency)) / 8;
+
+        item->fn(item->arg);
+
+        head++;
+        n++;
+        barrier();
+        ring->head = head;  /* publish the free slot to the producer */
+    }
+
+    if (n) {
+        ring->stats.drained += n;
+        ring->stats.batches++;
+    }
+}
+
+static void softirq_worker(void) {
+    softirq_ring_t* ring = &rings[cpu_id()];
+
+    for (;;) {
+        softirq_drain(ring);
+
+        /* Check-and-sleep with interrupts off so a raise between the
+           two cannot be lost; each context carries its own EFLAGS */
+        uint32_t flags = irq_save();
+        if (ring->head == ring->tail) {
+            if (scheduler_block(0) < 0) {
+                irq_restore(flags);
+                return;  /* not started by schedule(): run once */
+            }
+            irq_restore(flags);
+        } else {
+            irq_restore(flags);
+            scheduler_yield();  /* batch limit: let others run */
+        }
+    }
+}
+
+/* =========================
+   Initialize
+   ========================= */
+void softirq_init(void) {
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        softirq_ring_t* ring = &rings[cpu];
+        ring->head = 0;
+        ring->tail = 0;
+
+        ring->worker_pid = process_create(softirq_worker);
+        process_t* worker = get_process_by_pid(ring->worker_pid);
+        if (worker) worker->priority = SOFTIRQ_PRIORITY;
+    }
+}
+
+/* =========================
+   Raise deferred work
+   ========================= */
+int softirq_raise(softirq_fn_t fn, uint32_t arg) {
+    softirq_ring_t* ring = &rings[cpu_id()];
+    uint32_t tail = ring->tail;
+    uint32_t depth = tail - ring->head;
+
+    if (depth >= SOFTIRQ_RING_SIZE) {
+        ring->stats.dropped++;
+        return -1;
+    }
+
+    softirq_item_t* item = &ring->items[tail & (SOFTIRQ_RING_SIZE - 1)];
+    item->fn = fn;
+    item->arg = arg;
+    item->stamp = (uint32_t)rdtsc();
+    barrier();
+    ring->tail = tail + 1;  /* publish the item to the worker */
+
+    ring->stats.raised++;
+    if (depth + 1 > ring->stats.max_depth)
+        ring->stats.max_depth = depth + 1;
+
+    /* Kick the worker if it is asleep */
+    process_t* worker = get_process_by_pid(ring->worker_pid);
+    if (worker && worker->state == PROC_WAITING)
+        scheduler_wake(worker, 0);
+    return 0;
+}
+
+void softirq_get_stats(softirq_stats_t* out) {
+    softirq_ring_t* ring = &rings[cpu_id()];
+    *out = ring->stats;
+    out->depth = ring->tail - ring->head;
+}
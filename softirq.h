@@ -0,0 +1,37 @@
+#ifndef SOFTIRQ_H
+#define SOFTIRQ_H
+
+#include "types.h"
+
+/* Deferred work ("bottom halves").
+   Interrupt handlers queue small work items with softirq_raise(); a
+   high-priority kernel worker process runs them in batches with
+   interrupts enabled. */
+
+#define SOFTIRQ_RING_SIZE  64   /* per CPU, power of two */
+#define SOFTIRQ_BATCH      16   /* items per drain before yielding */
+#define SOFTIRQ_PRIORITY   8    /* worker base priority */
+
+typedef void (*softirq_fn_t)(uint32_t arg);
+
+typedef struct {
+    uint32_t raised;        /* items queued */
+    uint32_t drained;       /* items run */
+    uint32_t dropped;       /* ring full */
+    uint32_t batches;       /* drain passes */
+    uint32_t depth;         /* items waiting now */
+    uint32_t max_depth;
+    uint32_t avg_latency;   /* cycles from raise to run (moving average) */
+    uint32_t max_latency;
+} softirq_stats_t;
+
+/* Create the per-CPU worker processes */
+void softirq_init(void);
+
+/* Queue fn(arg) on this CPU; safe from interrupt context.
+   Returns -1 if the ring is full. */
+int softirq_raise(softirq_fn_t fn, uint32_t arg);
+
+void softirq_get_stats(softirq_stats_t* out);
+
+#endif
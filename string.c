@@ -21,4 +21,44 @@ char* strcpy(char* dest, const char* src) {
     char* original_dest = dest;
     while ((*dest++ = *src++));
     return original_dest;
+}
+
+int strncmp(const char* str1, const char* str2, size_t n) {
+    while (n && *str1 && (*str1 == *str2)) {
+        str1++;
+        str2++;
+        n--;
+    }
+    if (n == 0) return 0;
+    return *(unsigned char*)str1 - *(unsigned char*)str2;
+}
+
+/* Memory routines use string instructions directly so the compiler
+   cannot turn the loops back into calls to themselves. */
+void* memcpy(void* dest, const void* src, size_t n) {
+    void* d = dest;
+    size_t words = n >> 2;
+    size_t bytes = n & 3;
+    __asm__ volatile ("cld; rep movsl" : "+D"(d), "+S"(src), "+c"(words) : : "memory");
+    __asm__ volatile ("rep movsb" : "+D"(d), "+S"(src), "+c"(bytes) : : "memory");
+    return dest;
+}
+
+void* memmove(void* dest, const void* src, size_t n) {
+    if ((uint8_t*)dest <= (const uint8_t*)src ||
+        (uint8_t*)dest >= (const uint8_t*)src + n) {
+        return memcpy(dest, src, n);  /* forward copy is safe */
+    }
+
+    /* Overlapping with dest above src: copy backwards */
+    void* d = (uint8_t*)dest + n - 1;
+    const void* s = (const uint8_t*)src + n - 1;
+    __asm__ volatile ("std; rep movsb; cld" : "+D"(d), "+S"(s), "+c"(n) : : "memory");
+    return dest;
+}
+
+void* memset(void* dest, int c, size_t n) {
+    void* d = dest;
+    __asm__ volatile ("cld; rep stosb" : "+D"(d), "+c"(n) : "a"(c) : "memory");
+    return dest;
 }
\ No newline at end of file
@@ -7,5 +7,10 @@
 size_t strlen(const char* str);
 int strcmp(const char* str1, const char* str2);
 char* strcpy(char* dest, const char* src);
+int strncmp(const char* str1, const char* str2, size_t n);
+
+void* memcpy(void* dest, const void* src, size_t n);
+void* memmove(void* dest, const void* src, size_t n);
+void* memset(void* dest, int c, size_t n);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/* sync.c - Contended paths for mutexes and condition variables */
+#include "sync.h"
+#include "futex.h"
+#include "scheduler.h"
+
+int mutex_lock_slow(mutex_t* m) {
+    /* Mark the lock contended and sleep until the holder releases it;
+       a failed wait just means the value moved, so try again */
+    while (__sync_lock_test_and_set(&m->state, 2) != 0) {
+        if (scheduler_can_block()) {
+            futex_wait(&m->state, 2);
+            continue;
+        }
+
+        /* The null process cannot sleep: run whoever is ready instead,
+           since that is the only way the holder gets to unlock */
+        if (!get_ready_process())
+            return -1;
+        schedule();
+    }
+    return 0;
+}
+
+void mutex_unlock_slow(mutex_t* m) {
+    /* state was 2: there may be sleepers */
+    m->state = 0;
+    futex_wake(&m->state, 1);
+}
+
+int cond_wait(cond_t* c, mutex_t* m) {
+    int seq = c->seq;
+    if (!scheduler_can_block())
+        return -1;
+
+    __sync_fetch_and_add(&c->waiters, 1);
+    mutex_unlock(m);
+    futex_wait(&c->seq, seq);
+
+    /* Re-take as contended: other waiters may be queued behind us */
+    while (__sync_lock_test_and_set(&m->state, 2) != 0)
+        futex_wait(&m->state, 2);
+    __sync_fetch_and_sub(&c->waiters, 1);
+    return 0;
+}
+
+void cond_signal(cond_t* c) {
+    __sync_fetch_and_add(&c->seq, 1);
+    if (c->waiters)
+        futex_wake(&c->seq, 1);
+}
+
+void cond_broadcast(cond_t* c) {
+    __sync_fetch_and_add(&c->seq, 1);
+    if (c->waiters)
+        futex_wake(&c->seq, 0x7FFFFFFF);
+}
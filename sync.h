@@ -0,0 +1,52 @@
+/* sync.h - Mutexes and condition variables on futexes
+   The uncontended paths are a single atomic instruction and never
+   enter the futex layer; only a process that has to sleep does. */
+#ifndef SYNC_H
+#define SYNC_H
+
+#include "types.h"
+
+/* 0 = unlocked, 1 = locked, 2 = locked with (possible) sleepers */
+typedef struct {
+    volatile int state;
+} mutex_t;
+
+/* Bumped on every signal; waiters sleep on the value they saw.
+   Signals with nobody waiting stay out of the futex layer. */
+typedef struct {
+    volatile int seq;
+    volatile int waiters;
+} cond_t;
+
+#define MUTEX_INIT { 0 }
+#define COND_INIT  { 0, 0 }
+
+int mutex_lock_slow(mutex_t* m);
+void mutex_unlock_slow(mutex_t* m);
+
+/* The null process cannot sleep: on contention it runs the ready
+   processes until the lock frees up, and returns -1 without it if none
+   is left that could release it */
+static inline int mutex_lock(mutex_t* m) {
+    if (__sync_val_compare_and_swap(&m->state, 0, 1) != 0)
+        return mutex_lock_slow(m);
+    return 0;
+}
+
+static inline int mutex_trylock(mutex_t* m) {
+    return __sync_val_compare_and_swap(&m->state, 0, 1) == 0 ? 0 : -1;
+}
+
+static inline void mutex_unlock(mutex_t* m) {
+    if (__sync_fetch_and_sub(&m->state, 1) != 1)
+        mutex_unlock_slow(m);
+}
+
+/* Atomically release m and sleep until signalled; m is held on return.
+   Returns -1 at once, m still held, if the caller cannot sleep.
+   Signal and broadcast expect the caller to hold the same mutex. */
+int cond_wait(cond_t* c, mutex_t* m);
+void cond_signal(cond_t* c);
+void cond_broadcast(cond_t* c);
+
+#endif
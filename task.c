@@ -0,0 +1,371 @@
+/* task.c - Work-stealing task runtime on top of the process scheduler */
+#include "task.h"
+#include "process.h"
+#include "scheduler.h"
+#include "futex.h"
+#include "sync.h"
+#include "cpu.h"
+
+#define DEQUE_MASK (TASK_DEQUE_SIZE - 1)
+
+struct task {
+    task_fn_t fn;
+    void* arg;
+    volatile int done;
+    int runner;             /* worker that took it, -1 while queued */
+    struct task* next;      /* free list / injection queue */
+};
+
+/* Chase-Lev deque: the owner works at `bottom`, thieves CAS `top` */
+typedef struct {
+    volatile int top;
+    volatile int bottom;
+    task_t* buf[TASK_DEQUE_SIZE];
+} deque_t;
+
+typedef struct {
+    int pid;
+    deque_t deque;
+    task_t pool[TASK_POOL_SIZE];
+    task_t* free;           /* only touched by the owning worker */
+    int since_yield;
+    int depth;              /* tasks running nested on this stack */
+    task_stats_t stats;
+} task_worker_t;
+
+static task_worker_t workers[TASK_WORKERS];
+static int nr_workers;
+static uint8_t worker_stacks[TASK_WORKERS][TASK_STACK_SIZE]
+    __attribute__((aligned(16)));
+
+/* Tasks submitted from outside the workers */
+static mutex_t inject_lock = MUTEX_INIT;
+static task_t* inject_head;
+static task_t* inject_tail;
+
+/* Idle workers sleep on the epoch; bumping it wakes them */
+static volatile int task_epoch;
+static volatile int task_idle;
+
+/* =========================
+   Deque
+   ========================= */
+static int deque_push(deque_t* d, task_t* t) {
+    int b = d->bottom;
+    if (b - d->top >= TASK_DEQUE_SIZE)
+        return -1;
+
+    d->buf[b & DEQUE_MASK] = t;
+    __sync_synchronize();
+    d->bottom = b + 1;
+    return 0;
+}
+
+static task_t* deque_pop(deque_t* d) {
+    int b = d->bottom - 1;
+    d->bottom = b;
+    __sync_synchronize();
+    int t = d->top;
+
+    if (t > b) {                /* empty */
+        d->bottom = b + 1;
+        return 0;
+    }
+
+    task_t* task = d->buf[b & DEQUE_MASK];
+    if (t == b) {               /* last one: race the thieves for it */
+        if (!__sync_bool_compare_and_swap(&d->top, t, t + 1))
+            task = 0;
+        d->bottom = b + 1;
+    }
+    return task;
+}
+
+static task_t* deque_steal(deque_t* d) {
+    int t = d->top;
+    __sync_synchronize();
+    int b = d->bottom;
+
+    if (t >= b)
+        return 0;
+
+    task_t* task = d->buf[t & DEQUE_MASK];
+    if (!__sync_bool_compare_and_swap(&d->top, t, t + 1))
+        return 0;               /* lost to the owner or another thief */
+    return task;
+}
+
+/* =========================
+   Workers
+   ========================= */
+static task_worker_t* current_worker(void) {
+    process_t* p = get_current_process();
+    if (!p)
+        return 0;
+
+    for (int i = 0; i < nr_workers; i++) {
+        if (workers[i].pid == p->pid)
+            return &workers[i];
+    }
+    return 0;
+}
+
+/* The waker takes the woken worker off the idle count, so a burst of
+   spawns does not keep calling into the futex layer */
+static void task_kick(void) {
+    if (task_idle) {
+        __sync_fetch_and_add(&task_epoch, 1);
+        if (futex_wake(&task_epoch, 1))
+            __sync_fetch_and_sub(&task_idle, 1);
+    }
+}
+
+static task_t* take_injected(void) {
+    if (!inject_head)
+        return 0;
+
+    mutex_lock(&inject_lock);
+    task_t* t = inject_head;
+    if (t) {
+        inject_head = t->next;
+        if (!inject_head) inject_tail = 0;
+    }
+    mutex_unlock(&inject_lock);
+    return t;
+}
+
+static void inject(task_t* t) {
+    t->next = 0;
+    mutex_lock(&inject_lock);
+    if (inject_tail) inject_tail->next = t;
+    else inject_head = t;
+    inject_tail = t;
+    mutex_unlock(&inject_lock);
+    task_kick();
+}
+
+static void task_exec(task_worker_t* w, task_t* t) {
+    t->runner = w - workers;
+    w->depth++;
+    t->fn(t->arg);
+    w->depth--;
+    barrier();
+    t->done = 1;
+    w->stats.executed++;
+
+    /* One CPU: give thieves a turn now and then */
+    if (++w->since_yield >= TASK_YIELD_EVERY) {
+        w->since_yield = 0;
+        scheduler_yield();
+    }
+}
+
+/* Find one task (own deque, injected, then stolen) and run it */
+static int task_help(task_worker_t* w) {
+    task_t* t = deque_pop(&w->deque);
+    if (!t)
+        t = take_injected();
+
+    int self = w - workers;
+    for (int i = 1; !t && i < nr_workers; i++) {
+        t = deque_steal(&workers[(self + i) % nr_workers].deque);
+        if (t) w->stats.steals++;
+    }
+    if (!t)
+        return 0;
+
+    task_exec(w, t);
+    return 1;
+}
+
+static void task_worker(void) {
+    task_worker_t* w = current_worker();
+    if (!w)
+        return;
+
+    for (;;) {
+        if (task_help(w))
+            continue;
+
+        /* Re-check after reading the epoch so a kick cannot be lost */
+        int epoch = task_epoch;
+        if (task_help(w))
+            continue;
+
+        w->stats.parks++;
+        __sync_fetch_and_add(&task_idle, 1);
+        if (futex_wait(&task_epoch, epoch) < 0) {
+            __sync_fetch_and_sub(&task_idle, 1);
+            if (!scheduler_can_block())
+                return;     /* not started by schedule(): run once */
+        }
+    }
+}
+
+/* =========================
+   Initialize (first task_run)
+   ========================= */
+static void task_start_workers(void) {
+    for (int i = nr_workers; i < TASK_WORKERS; i++) {
+        task_worker_t* w = &workers[i];
+        w->deque.top = 0;
+        w->deque.bottom = 0;
+        w->since_yield = 0;
+        w->depth = 0;
+
+        w->free = 0;
+        for (int j = TASK_POOL_SIZE - 1; j >= 0; j--) {
+            w->pool[j].next = w->free;
+            w->free = &w->pool[j];
+        }
+
+        w->pid = process_create_on_stack(task_worker,
+                                         worker_stacks[i] + TASK_STACK_SIZE);
+        if (w->pid < 0)
+            break;
+        nr_workers++;
+    }
+}
+
+/* =========================
+   Spawn / join
+   ========================= */
+task_t* task_spawn(task_fn_t fn, void* arg) {
+    task_worker_t* w = current_worker();
+    task_t* t = w ? w->free : 0;
+
+    /* Outside a worker, or out of descriptors: just run it */
+    if (!t) {
+        if (w) w->stats.inlined++;
+        fn(arg);
+        return 0;
+    }
+
+    w->free = t->next;
+    t->fn = fn;
+    t->arg = arg;
+    t->done = 0;
+    t->runner = -1;
+
+    if (deque_push(&w->deque, t) < 0) {
+        t->next = w->free;
+        w->free = t;
+        w->stats.inlined++;
+        fn(arg);
+        return 0;
+    }
+
+    w->stats.spawned++;
+    task_kick();
+    return t;
+}
+
+void task_join(task_t* t) {
+    if (!t)
+        return;
+
+    /* The joiner is the spawner, so t goes back to this worker's pool */
+    task_worker_t* w = current_worker();
+
+    /* Not stolen: t is still at our bottom, run it like a call */
+    task_t* b = deque_pop(&w->deque);
+    if (b == t)
+        task_exec(w, t);
+    else if (b)
+        deque_push(&w->deque, b);
+
+    /* Stolen: help with other work while it runs elsewhere. On a deep
+       stack only leapfrog: whatever the thief has queued descends from
+       t, so running it always moves the join forward */
+    while (!t->done) {
+        if (w->depth < TASK_MAX_NEST) {
+            if (task_help(w))
+                continue;
+        } else if (t->runner >= 0) {
+            task_t* s = deque_steal(&workers[t->runner].deque);
+            if (s) {
+                w->stats.steals++;
+                task_exec(w, s);
+                continue;
+            }
+        }
+        scheduler_yield();
+    }
+
+    t->next = w->free;
+    w->free = t;
+}
+
+void task_run(task_fn_t fn, void* arg) {
+    if (nr_workers < TASK_WORKERS)
+        task_start_workers();
+
+    if (nr_workers == 0 || current_worker()) {
+        fn(arg);
+        return;
+    }
+
+    /* The root lives on our stack; we wait for it, so that is safe */
+    task_t root;
+    root.fn = fn;
+    root.arg = arg;
+    root.done = 0;
+    root.runner = -1;
+    inject(&root);
+
+    if (get_current_process()) {
+        while (!root.done)
+            scheduler_yield();
+    } else {
+        while (!root.done)
+            schedule();
+    }
+}
+
+/* =========================
+   parallel_for
+   Split in halves; the right half is spawned, the left run in place
+   ========================= */
+typedef struct {
+    int lo, hi, grain;
+    void (*body)(int i, void* arg);
+    void* arg;
+} pfor_range_t;
+
+static void pfor_task(void* a) {
+    pfor_range_t* r = (pfor_range_t*)a;
+
+    if (r->hi - r->lo <= r->grain) {
+        for (int i = r->lo; i < r->hi; i++)
+            r->body(i, r->arg);
+        return;
+    }
+
+    int mid = r->lo + (r->hi - r->lo) / 2;
+    pfor_range_t left = *r;
+    pfor_range_t right = *r;
+    left.hi = mid;
+    right.lo = mid;
+
+    task_t* t = task_spawn(pfor_task, &right);
+    pfor_task(&left);
+    task_join(t);
+}
+
+void task_parallel_for(int lo, int hi, int grain,
+                       void (*body)(int i, void* arg), void* arg) {
+    pfor_range_t r = { lo, hi, grain > 0 ? grain : 1, body, arg };
+    task_run(pfor_task, &r);
+}
+
+void task_get_stats(task_stats_t* out) {
+    task_stats_t total = { 0, 0, 0, 0, 0 };
+    for (int i = 0; i < nr_workers; i++) {
+        total.spawned += workers[i].stats.spawned;
+        total.inlined += workers[i].stats.inlined;
+        total.executed += workers[i].stats.executed;
+        total.steals += workers[i].stats.steals;
+        total.parks += workers[i].stats.parks;
+    }
+    *out = total;
+}
@@ -0,0 +1,54 @@
+/* task.h - Fine-grained task runtime
+   Stackless tasks run on a fixed set of worker processes. Each worker
+   owns a Chase-Lev deque: it pushes and pops at the bottom, idle
+   workers steal from the top. task_join() does not sleep, it keeps
+   running other tasks until the joined one is done.
+
+   The workers are created on the first task_run() and then hold
+   TASK_WORKERS of the MAX_PROCESSES process slots for good. Each has
+   its own TASK_STACK_SIZE stack. Past TASK_MAX_NEST nested tasks a
+   join only runs work queued by the thief of the joined task. */
+#ifndef TASK_H
+#define TASK_H
+
+#include "types.h"
+
+#define TASK_WORKERS      2
+#define TASK_DEQUE_SIZE   256   /* per worker, power of two */
+#define TASK_POOL_SIZE    256   /* task descriptors per worker */
+#define TASK_YIELD_EVERY  32    /* tasks run before letting other workers in */
+#define TASK_STACK_SIZE   16384 /* per worker, instead of a 4 KB pool slot */
+#define TASK_MAX_NEST     16    /* past this, a join only leapfrogs */
+
+typedef void (*task_fn_t)(void* arg);
+
+typedef struct task task_t;
+
+typedef struct {
+    uint32_t spawned;
+    uint32_t inlined;       /* pool or deque full: ran in the spawner */
+    uint32_t executed;
+    uint32_t steals;
+    uint32_t parks;         /* worker went to sleep with no work */
+} task_stats_t;
+
+/* Queue fn(arg) as a child of the running task. Returns a handle for
+   task_join, or 0 if it already ran inline. `arg` must stay valid
+   until the join. */
+task_t* task_spawn(task_fn_t fn, void* arg);
+
+/* Wait for t, running other tasks meanwhile; t is freed */
+void task_join(task_t* t);
+
+/* Run fn(arg) on the workers and wait for it; callable from the
+   null process, an ordinary process or a task. Starts the workers
+   on first use (runs fn inline if no process slot is free). */
+void task_run(task_fn_t fn, void* arg);
+
+/* body(i, arg) for i in [lo, hi), split down to `grain` iterations */
+void task_parallel_for(int lo, int hi, int grain,
+                       void (*body)(int i, void* arg), void* arg);
+
+void task_get_stats(task_stats_t* out);
+
+#endif
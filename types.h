@@ -2,6 +2,7 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+typedef unsigned long long uint64_t;
 typedef unsigned int   uint32_t;
 typedef unsigned short uint16_t;
 typedef unsigned char  uint8_t;
@@ -0,0 +1,13 @@
+/* big.c - ELF program with a large read-only table it barely touches,
+   used to compare demand paging against eager loading */
+#include "kapi.h"
+
+#define TABLE_WORDS (256 * 1024)    /* 1 MB */
+
+const unsigned int table[TABLE_WORDS] = { 42 };
+
+void _start(const kapi_t* k) {
+    volatile int index = 0;     /* keep the table from being folded away */
+    if (table[index] != 42)
+        k->puts("[big] bad table\n");
+}
@@ -0,0 +1,13 @@
+/* hello.c - Minimal ELF program: greets and counts its runs */
+#include "kapi.h"
+
+static int runs;    /* private per process: lives in a writable page */
+
+void _start(const kapi_t* k) {
+    runs++;
+    k->puts("[hello] pid ");
+    k->putint(k->getpid());
+    k->puts(" run ");
+    k->putint(runs);
+    k->puts("\n");
+}
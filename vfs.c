@@ -0,0 +1,78 @@
+#include "vfs.h"
+#include "initrd.h"
+
+typedef struct {
+    const initrd_file_t* file;  /* 0 = slot free */
+    uint32_t offset;
+} open_file_t;
+
+static open_file_t open_files[MAX_OPEN_FILES];
+
+/* =========================
+   Open / close
+   ========================= */
+int vfs_open(const char* path) {
+    const initrd_file_t* f = initrd_lookup(path);
+    if (!f)
+        return -1;
+
+    for (int fd = 0; fd < MAX_OPEN_FILES; fd++) {
+        if (!open_files[fd].file) {
+            open_files[fd].file = f;
+            open_files[fd].offset = 0;
+            return fd;
+        }
+    }
+    return -1;  /* descriptor table full */
+}
+
+int vfs_close(int fd) {
+    if (fd < 0 || fd >= MAX_OPEN_FILES || !open_files[fd].file)
+        return -1;
+
+    open_files[fd].file = 0;
+    return 0;
+}
+
+/* =========================
+   Zero-copy read
+   ========================= */
+int vfs_read(int fd, const void** data, uint32_t len) {
+    if (fd < 0 || fd >= MAX_OPEN_FILES || !open_files[fd].file)
+        return -1;
+
+    open_file_t* of = &open_files[fd];
+    uint32_t left = of->file->size - of->offset;
+    if (len > left)
+        len = left;
+
+    *data = of->file->data + of->offset;
+    of->offset += len;
+    return len;
+}
+
+/* =========================
+   Metadata
+   ========================= */
+static void fill_stat(const initrd_file_t* f, vfs_stat_t* st) {
+    st->name = f->name;
+    st->size = f->size;
+}
+
+int vfs_stat(const char* path, vfs_stat_t* st) {
+    const initrd_file_t* f = initrd_lookup(path);
+    if (!f)
+        return -1;
+
+    fill_stat(f, st);
+    return 0;
+}
+
+int vfs_readdir(int index, vfs_stat_t* st) {
+    const initrd_file_t* f = initrd_get(index);
+    if (!f)
+        return -1;
+
+    fill_stat(f, st);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef VFS_H
+#define VFS_H
+
+#include "types.h"
+
+/* Small read-only VFS over the initrd.
+   vfs_read() does not copy: it returns a pointer into the file image. */
+
+#define MAX_OPEN_FILES 16
+
+typedef struct {
+    const char* name;
+    uint32_t size;
+} vfs_stat_t;
+
+int vfs_open(const char* path);
+int vfs_close(int fd);
+
+/* Up to len bytes from the current offset; *data points at them.
+   Returns the byte count (0 at end of file) or -1. */
+int vfs_read(int fd, const void** data, uint32_t len);
+
+int vfs_stat(const char* path, vfs_stat_t* st);
+
+/* Enumerate files: fills *st for entry `index`, -1 past the end */
+int vfs_readdir(int index, vfs_stat_t* st);
+
+#endif
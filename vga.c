@@ -0,0 +1,110 @@
+/* vga.c - VGA text-mode driver (80x25, framebuffer at 0xB8000) */
+#include "vga.h"
+#include "io.h"
+#include "string.h"
+
+#define VGA_MEMORY  0xB8000
+#define VGA_WIDTH   80
+#define VGA_HEIGHT  25
+#define VGA_ATTR    0x07        /* light grey on black */
+
+#define VGA_CRTC_INDEX 0x3D4
+#define VGA_CRTC_DATA  0x3D5
+
+static uint16_t* const vga_buffer = (uint16_t*)VGA_MEMORY;
+static int cursor_row;
+static int cursor_col;
+
+static inline uint16_t vga_cell(char c) {
+    return (uint16_t)(uint8_t)c | (VGA_ATTR << 8);
+}
+
+/* Move the blinking hardware cursor */
+static void vga_update_cursor(void) {
+    uint16_t pos = cursor_row * VGA_WIDTH + cursor_col;
+    outb(VGA_CRTC_INDEX, 0x0F);
+    outb(VGA_CRTC_DATA, pos & 0xFF);
+    outb(VGA_CRTC_INDEX, 0x0E);
+    outb(VGA_CRTC_DATA, pos >> 8);
+}
+
+static void vga_clear_rows(int first, int count) {
+    uint16_t* cell = vga_buffer + first * VGA_WIDTH;
+    for (int i = 0; i < count * VGA_WIDTH; i++)
+        cell[i] = vga_cell(' ');
+}
+
+/* Scroll up by `lines` rows with a single memmove */
+static void vga_scroll(int lines) {
+    if (lines >= VGA_HEIGHT) {
+        vga_clear_rows(0, VGA_HEIGHT);
+        return;
+    }
+
+    memmove(vga_buffer, vga_buffer + lines * VGA_WIDTH,
+            (VGA_HEIGHT - lines) * VGA_WIDTH * sizeof(uint16_t));
+    vga_clear_rows(VGA_HEIGHT - lines, lines);
+}
+
+/* Cursor movement for one character (no framebuffer access) */
+static void vga_step(char c, int* row, int* col) {
+    switch (c) {
+    case '\n':
+        *col = 0;
+        (*row)++;
+        break;
+    case '\r':
+        *col = 0;
+        break;
+    case '\b':
+        if (*col > 0) (*col)--;
+        break;
+    case '\t':
+        *col = (*col + 8) & ~7;
+        if (*col >= VGA_WIDTH) {
+            *col = 0;
+            (*row)++;
+        }
+        break;
+    default:
+        if (++(*col) == VGA_WIDTH) {
+            *col = 0;
+            (*row)++;
+        }
+        break;
+    }
+}
+
+void vga_clear(void) {
+    vga_clear_rows(0, VGA_HEIGHT);
+    cursor_row = 0;
+    cursor_col = 0;
+    vga_update_cursor();
+}
+
+void vga_init(void) {
+    vga_clear();
+}
+
+void vga_write(const char* str, uint32_t len) {
+    /* Dry run to count line feeds, then scroll once for the whole write */
+    int lines = 0;
+    int col = cursor_col;
+    for (uint32_t i = 0; i < len; i++)
+        vga_step(str[i], &lines, &col);
+
+    int overflow = cursor_row + lines - (VGA_HEIGHT - 1);
+    if (overflow > 0) {
+        vga_scroll(overflow);
+        cursor_row -= overflow;  /* may go negative: those rows scrolled off */
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        char c = str[i];
+        if ((uint8_t)c >= ' ' && cursor_row >= 0)
+            vga_buffer[cursor_row * VGA_WIDTH + cursor_col] = vga_cell(c);
+        vga_step(c, &cursor_row, &cursor_col);
+    }
+
+    vga_update_cursor();
+}
@@ -0,0 +1,11 @@
+/* vga.h - VGA text-mode driver interface */
+#ifndef VGA_H
+#define VGA_H
+
+#include "types.h"
+
+void vga_init(void);
+void vga_write(const char* str, uint32_t len);
+void vga_clear(void);
+
+#endif